@@ -0,0 +1,55 @@
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "nldb/LOG/log.hpp"
+#include "nldb/Query/Query.hpp"
+#include "nldb/SQL3Implementation.hpp"
+#include "nldb/backends/sqlite3/DB/DB.hpp"
+
+using namespace nldb;
+
+int main(int argc, char* argv[]) {
+    nldb::LogManager::Initialize();
+
+    const auto printHelp = []() {
+        std::cout
+            << "\t usage: ./load file.db cars cars.json  load a json array or "
+               "newline delimited json into the collection cars"
+               "\n\t usage: ./load file.db cars -  same but reading stdin\n";
+    };
+
+    if (argc > 1 && (strcmp(argv[1], "--help") == 0 ||
+                     strcmp(argv[1], "-help") == 0)) {
+        printHelp();
+        return 0;
+    } else if (argc <= 3) {
+        NLDB_ERROR(
+            "Expecting the database file, the collection and the input file.");
+        printHelp();
+        return 1;
+    }
+
+    DBSL3 db;
+
+    if (!db.open(argv[1])) {
+        NLDB_ERROR("Could not open the database '{}' \n", argv[1]);
+        db.throwLastError();
+    }
+
+    Query<DBSL3> query(&db);
+
+    LoadStats stats;
+    if (strcmp(argv[3], "-") == 0) {
+        stats = query.from(argv[2]).load(std::cin);
+    } else {
+        stats = query.from(argv[2]).loadFile(argv[3]);
+    }
+
+    std::cout << "Loaded " << stats.documents << " documents in "
+              << stats.elapsed.count() << " ms ("
+              << (long long)stats.documentsPerSecond() << " documents/s)"
+              << std::endl;
+
+    return 0;
+}
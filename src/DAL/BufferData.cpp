@@ -1,41 +1,54 @@
 #include "nldb/DAL/BufferData.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <utility>
 
 #include "nldb/LOG/log.hpp"
 #include "nldb/Profiling/Profiler.hpp"
 
 namespace nldb {
+    namespace {
+        // see BufferData::Staging
+        thread_local BufferData::Staging* threadStaging = nullptr;
+    }  // namespace
 
-    // how many as you can fit in `bytes`
+    // how many as you can fit in `bytes`, at least one or adding would never
+    // succeed
     template <typename T>
     constexpr int bufferSize(int bytes) {
-        return (int)(bytes / sizeof(T));
+        return std::max((int)(bytes / sizeof(T)), 1);
     }
 
     template <typename T, typename L>
-    inline double bufferOccupancy(Buffer<T, L>& buffer) {
-        return (double)buffer.Size() * 100.0 / (double)buffer.Capacity();
+    inline double bufferOccupancy(DoubleBuffer<T, L>& buffer) {
+        return (double)buffer.FrozenSize() * 100.0 /
+               (double)buffer.Capacity();
     }
 
     BufferData::BufferData(IDB* pDb, int pSmallBufferSize,
-                           int pMediumBufferSize, int pLargeBufferSize)
-        : bufferCollection(bufferSize<BufferValueCollection>(pSmallBufferSize)),
+                           int pMediumBufferSize, int pLargeBufferSize,
+                           int pFlushesPerCommit, int pCommitMaxDelayMs)
+        : bufferCollection(bufferSize<BufferValueCollection>(pSmallBufferSize),
+                           pSmallBufferSize),
           bufferRootProperty(
-              bufferSize<BufferValueRootProperty>(pSmallBufferSize)),
-          bufferProperty(bufferSize<BufferValueProperty>(pMediumBufferSize)),
-          bufferStringLike(bufferSize<BufferValueStringLike>(pLargeBufferSize)),
+              bufferSize<BufferValueRootProperty>(pSmallBufferSize),
+              pSmallBufferSize),
+          bufferProperty(bufferSize<BufferValueProperty>(pMediumBufferSize),
+                         pMediumBufferSize),
+          bufferStringLike(bufferSize<BufferValueStringLike>(pLargeBufferSize),
+                           pLargeBufferSize),
+          bufferInteger(bufferSize<BufferValueInteger>(pLargeBufferSize)),
+          bufferDouble(bufferSize<BufferValueDouble>(pLargeBufferSize)),
           bufferDependentObject(
               bufferSize<BufferValueDependentObject>(pMediumBufferSize)),
           bufferIndependentObject(
               bufferSize<BufferValueIndependentObject>(pSmallBufferSize)),
-          conn(pDb) {}
+          conn(pDb),
+          flushesPerCommit(std::max(pFlushesPerCommit, 1)),
+          commitMaxDelay(pCommitMaxDelayMs) {}
 
     void BufferData::pushPendingData() {
-        NLDB_PROFILE_SCOPE("Flush data");
-
-        NLDB_PERF_SUCCESS("FLUSHING PENDING DATA");
-
 #if NLDB_LOGGING
         if (!lock.try_lock()) {
             NLDB_TRACE("Someone else is flushing the data");
@@ -46,73 +59,413 @@ namespace nldb {
 
         std::lock_guard<std::mutex> guard(lock);
 
-        if (bufferRootProperty.Size() > 0) {
-            NLDB_PERF_SUCCESS("RootProperty: {}%",
-                              bufferOccupancy(bufferRootProperty));
-            this->pushRootProperties();
+        throwFlushError();
+        flushLocked();
+    }
+
+    void BufferData::throwFlushError() {
+        if (flushError) {
+            std::rethrow_exception(std::exchange(flushError, nullptr));
         }
+    }
 
-        if (bufferCollection.Size() > 0) {
-            NLDB_PERF_SUCCESS("Collection: {}%",
-                              bufferOccupancy(bufferCollection));
+    void BufferData::flushLocked() {
+        if (!freezeBuffers()) {
+            if (isTransactionOverdue()) commitTransaction();
+            return;
+        }
 
-            this->pushCollections();
+        try {
+            writeFrozenData();
+        } catch (...) {
+            if (onDiscard) onDiscard();
+            throw;
         }
+    }
+
+    bool BufferData::freezeBuffers() {
+        // freeze all of them, not only up to the first one with data
+        bool any = false;
+        any |= bufferRootProperty.Freeze() > 0;
+        any |= bufferCollection.Freeze() > 0;
+        any |= bufferProperty.Freeze() > 0;
+        any |= bufferIndependentObject.Freeze() > 0;
+        any |= bufferDependentObject.Freeze() > 0;
+        any |= bufferStringLike.Freeze() > 0;
+        any |= bufferInteger.Freeze() > 0;
+        any |= bufferDouble.Freeze() > 0;
+
+        return any;
+    }
+
+    void BufferData::writeFrozenData() {
+        NLDB_PROFILE_SCOPE("Flush data");
+
+        NLDB_PERF_SUCCESS("FLUSHING PENDING DATA");
+
+        // if the user has an open transaction, write in it
+        if (!transactionOpen && !conn->isInTransaction()) {
+            conn->begin();
+            transactionOpen = true;
+            transactionStart = std::chrono::steady_clock::now();
+        }
+
+        try {
+            if (bufferRootProperty.FrozenSize() > 0) {
+                NLDB_PERF_SUCCESS("RootProperty: {}%",
+                                  bufferOccupancy(bufferRootProperty));
+                this->pushRootProperties();
+            }
+
+            if (bufferCollection.FrozenSize() > 0) {
+                NLDB_PERF_SUCCESS("Collection: {}%",
+                                  bufferOccupancy(bufferCollection));
+
+                this->pushCollections();
+            }
+
+            if (bufferProperty.FrozenSize() > 0) {
+                NLDB_PERF_SUCCESS("Property: {}%",
+                                  bufferOccupancy(bufferProperty));
+
+                this->pushProperties();
+            }
+
+            if (bufferIndependentObject.FrozenSize() > 0) {
+                NLDB_PERF_SUCCESS("IndependentObject: {}%",
+                                  bufferOccupancy(bufferIndependentObject));
+
+                this->pushIndependentObjects();
+            }
+
+            if (bufferDependentObject.FrozenSize() > 0) {
+                NLDB_PERF_SUCCESS("DependentObject: {}%",
+                                  bufferOccupancy(bufferDependentObject));
+
+                this->pushDependentObjects();
+            }
+
+            if (bufferStringLike.FrozenSize() > 0) {
+                NLDB_PERF_SUCCESS("StringLike: {}%",
+                                  bufferOccupancy(bufferStringLike));
+
+                this->pushStringLikeValues();
+            }
+
+            if (bufferInteger.FrozenSize() > 0) {
+                NLDB_PERF_SUCCESS("Integer: {}%",
+                                  bufferOccupancy(bufferInteger));
+
+                this->pushIntegerValues();
+            }
 
-        if (bufferProperty.Size() > 0) {
-            NLDB_PERF_SUCCESS("Property: {}%", bufferOccupancy(bufferProperty));
+            if (bufferDouble.FrozenSize() > 0) {
+                NLDB_PERF_SUCCESS("Double: {}%", bufferOccupancy(bufferDouble));
 
-            this->pushProperties();
+                this->pushDoubleValues();
+            }
+        } catch (const std::exception& e) {
+            NLDB_ERROR("Couldn't flush the buffered data: {}", e.what());
+
+            // values could reference objects or properties that were not
+            // written, even the ones added while writing. Discard everything
+            if (transactionOpen) {
+                conn->rollback();
+                transactionOpen = false;
+                uncommittedFlushes = 0;
+            }
+
+            resetBuffers();
+
+            throw;
+        }
+
+        if (transactionOpen && (++uncommittedFlushes >= flushesPerCommit ||
+                                isTransactionOverdue())) {
+            commitTransaction();
         }
 
-        if (bufferIndependentObject.Size() > 0) {
-            NLDB_PERF_SUCCESS("IndependentObject: {}%",
-                              bufferOccupancy(bufferIndependentObject));
+        NLDB_TRACE("Flushing done");
+    }
 
-            this->pushIndependentObjects();
+    void BufferData::commitTransaction() {
+        if (transactionOpen) {
+            conn->commit();
+            transactionOpen = false;
+            uncommittedFlushes = 0;
         }
+    }
+
+    bool BufferData::isTransactionOverdue() const {
+        return transactionOpen &&
+               std::chrono::steady_clock::now() - transactionStart >=
+                   commitMaxDelay;
+    }
+
+    void BufferData::commitPendingData() {
+        std::lock_guard<std::mutex> guard(lock);
+
+        commitTransaction();
+    }
+
+    void BufferData::pushPendingValue(snowflake propID, snowflake objID) {
+        // no flush is running while it's held, so only the active halves
+        // can have it
+        std::lock_guard<std::mutex> guard(lock);
 
-        if (bufferDependentObject.Size() > 0) {
-            NLDB_PERF_SUCCESS("DependentObject: {}%",
-                              bufferOccupancy(bufferDependentObject));
+        throwFlushError();
 
-            this->pushDependentObjects();
+        auto isValue = [propID, objID](const auto& val) {
+            return val.propID == propID && val.objID == objID;
+        };
+
+        if (bufferInteger.AnyActive(isValue) ||
+            bufferDouble.AnyActive(isValue)) {
+            flushLocked();
         }
 
-        if (bufferStringLike.Size() > 0) {
-            NLDB_PERF_SUCCESS("StringLike: {}%",
-                              bufferOccupancy(bufferStringLike));
+        commitTransaction();
+    }
+
+    void BufferData::discardPendingData() {
+        std::lock_guard<std::mutex> guard(lock);
+
+        resetBuffers();
+    }
+
+    void BufferData::schedulePendingData() {
+        if (flusher.joinable()) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                throwFlushError();
+            }
 
-            this->pushStringLikeValues();
+            requestBackgroundFlush();
+        } else {
+            pushPendingData();
         }
+    }
 
-        NLDB_TRACE("Flushing done");
+    void BufferData::startBackgroundFlusher(
+        std::chrono::milliseconds maxLatency, double pFillRatio,
+        double pHighWatermark) {
+        if (flusher.joinable()) return;
+
+        NLDB_ASSERT(operationLock, "the flusher needs the operations lock");
+
+        flushMaxLatency = maxLatency;
+        fillRatio = pFillRatio;
+        highWatermark = pHighWatermark;
+        stopFlusher = false;
+
+        flusher = std::thread(&BufferData::runBackgroundFlusher, this);
+    }
+
+    void BufferData::stopBackgroundFlusher() {
+        if (!flusher.joinable()) return;
+
+        {
+            std::lock_guard<std::mutex> guard(flusherMtx);
+            stopFlusher = true;
+        }
+
+        flusherCv.notify_one();
+        flusher.join();
+    }
+
+    void BufferData::requestBackgroundFlush() {
+        {
+            std::lock_guard<std::mutex> guard(flusherMtx);
+            flushRequested = true;
+        }
+
+        flusherCv.notify_one();
+    }
+
+    void BufferData::runBackgroundFlusher() {
+        std::unique_lock<std::mutex> guard(flusherMtx);
+
+        while (!stopFlusher) {
+            const bool requested = flusherCv.wait_for(
+                guard, flushMaxLatency,
+                [this]() { return stopFlusher || flushRequested; });
+
+            if (stopFlusher) break;
+
+            flushRequested = false;
+            guard.unlock();
+
+            bool discarded = false;
+
+            try {
+                std::unique_lock<std::recursive_mutex> operation(
+                    *operationLock);
+                std::lock_guard<std::mutex> flush(lock);
+
+                const bool frozen = freezeBuffers();
+
+                // let the operations keep filling the buffers while writing
+                operation.unlock();
+
+                if (frozen) writeFrozenData();
+
+                // nothing else came in time, don't let coalesced flushes wait
+                // any longer
+                if (!requested || isTransactionOverdue()) commitTransaction();
+            } catch (const std::exception& e) {
+                NLDB_ERROR("Background flush failed: {}", e.what());
+                discarded = true;
+
+                // the data was already acknowledged, report it to whoever
+                // comes next
+                std::lock_guard<std::mutex> flush(lock);
+                if (!flushError) flushError = std::current_exception();
+            }
+
+            if (discarded && onDiscard) {
+                // the callback might touch what the operations use
+                std::lock_guard<std::recursive_mutex> operation(*operationLock);
+                onDiscard();
+            }
+
+            guard.lock();
+        }
+    }
+
+    void BufferData::setOnDiscard(std::function<void()> callback) {
+        std::lock_guard<std::mutex> guard(lock);
+        onDiscard = std::move(callback);
+    }
+
+    void BufferData::setOperationLock(std::recursive_mutex* pOperationLock) {
+        operationLock = pOperationLock;
+    }
+
+    void BufferData::checkFill(double fill) {
+        if (!flusher.joinable()) return;
+
+        if (fill >= highWatermark) {
+            this->pushPendingData();
+        } else if (fill >= fillRatio) {
+            requestBackgroundFlush();
+        }
+    }
+
+    BufferData::Staging::Staging(BufferData& pOwner)
+        : owner(pOwner),
+          // it grows with the strings, most insertions are small
+          arena(4096),
+          previous(threadStaging) {
+        threadStaging = this;
+    }
+
+    BufferData::Staging::~Staging() { threadStaging = previous; }
+
+    void BufferData::Staging::merge() { owner.mergeStaging(*this); }
+
+    void BufferData::Staging::clear() {
+        stringLike.clear();
+        integer.clear();
+        doubles.clear();
+        dependentObject.clear();
+        independentObject.clear();
+        arena.Reset();
+    }
+
+    BufferData::Staging* BufferData::currentStaging() {
+        return threadStaging && &threadStaging->owner == this ? threadStaging
+                                                              : nullptr;
+    }
+
+    void BufferData::mergeStaging(Staging& staging) {
+        // a freeze takes it too, so it gets all of them or none, unless they
+        // don't fit
+        std::unique_lock<std::recursive_mutex> operation;
+        if (operationLock) {
+            operation = std::unique_lock<std::recursive_mutex>(*operationLock);
+        }
+
+        const double fill = std::max({
+            _addStaged(staging.independentObject, bufferIndependentObject),
+            _addStaged(staging.dependentObject, bufferDependentObject),
+            _addStaged(staging.stringLike, bufferStringLike,
+                       &BufferValueStringLike::value),
+            _addStaged(staging.integer, bufferInteger),
+            _addStaged(staging.doubles, bufferDouble),
+        });
+
+        staging.clear();
+
+        checkFill(fill);
+    }
+
+    void BufferData::resetBuffers() {
+        bufferRootProperty.Reset();
+        bufferCollection.Reset();
+        bufferProperty.Reset();
+        bufferIndependentObject.Reset();
+        bufferDependentObject.Reset();
+        bufferStringLike.Reset();
+        bufferInteger.Reset();
+        bufferDouble.Reset();
     }
 
     void BufferData::add(const BufferValueCollection& val) {
-        _add(val, bufferCollection);
+        _add(val, bufferCollection, &BufferValueCollection::name);
     }
 
     void BufferData::add(const BufferValueRootProperty& val) {
-        _add(val, bufferRootProperty);
+        _add(val, bufferRootProperty, &BufferValueRootProperty::name);
     }
 
     void BufferData::add(const BufferValueProperty& val) {
-        _add(val, bufferProperty);
+        _add(val, bufferProperty, &BufferValueProperty::name);
     }
 
     void BufferData::add(const BufferValueStringLike& val) {
-        _add(val, bufferStringLike);
+        if (Staging* staging = currentStaging()) {
+            BufferValueStringLike staged = val;
+            staged.value = staging->arena.Store(val.value);
+
+            staging->add(staging->stringLike, staged, bufferStringLike);
+        } else {
+            _add(val, bufferStringLike, &BufferValueStringLike::value);
+        }
+    }
+
+    void BufferData::add(const BufferValueInteger& val) {
+        if (Staging* staging = currentStaging()) {
+            staging->add(staging->integer, val, bufferInteger);
+        } else {
+            _add(val, bufferInteger);
+        }
+    }
+
+    void BufferData::add(const BufferValueDouble& val) {
+        if (Staging* staging = currentStaging()) {
+            staging->add(staging->doubles, val, bufferDouble);
+        } else {
+            _add(val, bufferDouble);
+        }
     }
 
     void BufferData::add(const BufferValueDependentObject& val) {
-        _add(val, bufferDependentObject);
+        if (Staging* staging = currentStaging()) {
+            staging->add(staging->dependentObject, val, bufferDependentObject);
+        } else {
+            _add(val, bufferDependentObject);
+        }
     }
 
     void BufferData::add(const BufferValueIndependentObject& val) {
-        _add(val, bufferIndependentObject);
+        if (Staging* staging = currentStaging()) {
+            staging->add(staging->independentObject, val,
+                         bufferIndependentObject);
+        } else {
+            _add(val, bufferIndependentObject);
+        }
     }
 
-    BufferData::~BufferData() {}
+    BufferData::~BufferData() { stopBackgroundFlusher(); }
 
 }  // namespace nldb
\ No newline at end of file
@@ -6,7 +6,6 @@
 #include "nldb/DAL/IRepositoryCollection.hpp"
 #include "nldb/LOG/log.hpp"
 #include "nldb/Property/Property.hpp"
-#include "nldb/Utils/Thread.hpp"
 #include "nldb/typedef.hpp"
 
 namespace nldb {
@@ -17,7 +16,7 @@ namespace nldb {
 
     snowflake BufferedRepositoryCollection::add(const std::string& name,
                                                 snowflake ownerID) {
-        snowflake id = SnowflakeGenerator::generate(getThreadID());
+        snowflake id = SnowflakeGenerator::generate();
 
         bufferData->add(BufferValueCollection {
             .id = id, .name = name, .owner_id = ownerID});
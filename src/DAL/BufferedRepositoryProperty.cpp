@@ -3,7 +3,6 @@
 #include "nldb/LOG/log.hpp"
 #include "nldb/Property/Property.hpp"
 #include "nldb/SnowflakeGenerator.hpp"
-#include "nldb/Utils/Thread.hpp"
 #include "nldb/typedef.hpp"
 
 namespace nldb {
@@ -13,7 +12,7 @@ namespace nldb {
         : repo(std::move(pRepo)), bufferData(bufferData) {}
 
     snowflake BufferedRepositoryProperty::add(const std::string& name) {
-        snowflake id = SnowflakeGenerator::generate(getThreadID());
+        snowflake id = SnowflakeGenerator::generate();
 
         bufferData->add(BufferValueRootProperty {.id = id, .name = name});
 
@@ -23,7 +22,7 @@ namespace nldb {
     snowflake BufferedRepositoryProperty::add(const std::string& name,
                                               snowflake collectionID,
                                               PropertyType type) {
-        snowflake id = SnowflakeGenerator::generate(getThreadID());
+        snowflake id = SnowflakeGenerator::generate();
 
         bufferData->add(BufferValueProperty {
             .id = id, .name = name, .coll_id = collectionID, .type = type});
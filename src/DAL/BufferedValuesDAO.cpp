@@ -11,7 +11,6 @@
 #include "nldb/LOG/log.hpp"
 #include "nldb/Property/Property.hpp"
 #include "nldb/Utils/ParamsBindHelpers.hpp"
-#include "nldb/Utils/Thread.hpp"
 
 #define USE_BUFFER
 
@@ -23,14 +22,26 @@ namespace nldb {
 
     void BufferedValuesDAO::addStringLike(snowflake propID, snowflake objID,
                                           PropertyType type,
-                                          std::string value) {
+                                          std::string_view value) {
         bufferData->add(BufferValueStringLike {
             .propID = propID, .objID = objID, .type = type, .value = value});
     }
 
+    void BufferedValuesDAO::addInteger(snowflake propID, snowflake objID,
+                                       int64_t value) {
+        bufferData->add(BufferValueInteger {
+            .propID = propID, .objID = objID, .value = value});
+    }
+
+    void BufferedValuesDAO::addDouble(snowflake propID, snowflake objID,
+                                      double value) {
+        bufferData->add(BufferValueDouble {
+            .propID = propID, .objID = objID, .value = value});
+    }
+
     snowflake BufferedValuesDAO::addObject(snowflake propID,
                                            std::optional<snowflake> objID) {
-        snowflake newId = SnowflakeGenerator::generate(getThreadID());
+        snowflake newId = SnowflakeGenerator::generate();
 
         if (objID.has_value()) {
             bufferData->add(BufferValueDependentObject {
@@ -58,8 +69,46 @@ namespace nldb {
 
     void BufferedValuesDAO::updateStringLike(snowflake propID, snowflake objID,
                                              PropertyType type,
-                                             std::string value) {
-        repo->updateStringLike(propID, objID, type, std::move(value));
+                                             std::string_view value) {
+        bufferData->commitPendingData();
+        repo->updateStringLike(propID, objID, type, value);
+    }
+
+    // the buffered values are flushed with upserts, see `BufferData`
+    void BufferedValuesDAO::upsertStringLike(snowflake propID, snowflake objID,
+                                             PropertyType type,
+                                             std::string_view value) {
+        addStringLike(propID, objID, type, value);
+    }
+
+    void BufferedValuesDAO::upsertInteger(snowflake propID, snowflake objID,
+                                          int64_t value) {
+        addInteger(propID, objID, value);
+    }
+
+    void BufferedValuesDAO::upsertDouble(snowflake propID, snowflake objID,
+                                         double value) {
+        addDouble(propID, objID, value);
+    }
+
+    // The writes that skip the buffer commit the flushes left open first, or
+    // a later failed flush would roll them back too.
+
+    // the operators combine the stored value, so it has to be written first
+    void BufferedValuesDAO::applyIntegerOperator(snowflake propID,
+                                                 snowflake objID,
+                                                 UpdateOperator op,
+                                                 int64_t value) {
+        bufferData->pushPendingValue(propID, objID);
+        repo->applyIntegerOperator(propID, objID, op, value);
+    }
+
+    void BufferedValuesDAO::applyDoubleOperator(snowflake propID,
+                                                snowflake objID,
+                                                UpdateOperator op,
+                                                double value) {
+        bufferData->pushPendingValue(propID, objID);
+        repo->applyDoubleOperator(propID, objID, op, value);
     }
 
     bool BufferedValuesDAO::exists(snowflake propID, snowflake objID,
@@ -73,10 +122,35 @@ namespace nldb {
     }
 
     void BufferedValuesDAO::removeObject(snowflake objID) {
+        bufferData->commitPendingData();
         return repo->removeObject(objID);
     }
 
     bool BufferedValuesDAO::existsObject(snowflake objID) {
         return repo->existsObject(objID);
     }
+
+    void BufferedValuesDAO::createIndex(snowflake propID, PropertyType type) {
+        bufferData->commitPendingData();
+        repo->createIndex(propID, type);
+    }
+
+    void BufferedValuesDAO::dropIndex(snowflake propID, PropertyType type) {
+        bufferData->commitPendingData();
+        repo->dropIndex(propID, type);
+    }
+
+    std::vector<snowflake> BufferedValuesDAO::findIndexedProperties() {
+        return repo->findIndexedProperties();
+    }
+
+    void BufferedValuesDAO::suspendIndex(snowflake propID) {
+        bufferData->commitPendingData();
+        repo->suspendIndex(propID);
+    }
+
+    void BufferedValuesDAO::restoreIndexes() {
+        bufferData->commitPendingData();
+        repo->restoreIndexes();
+    }
 }  // namespace nldb
\ No newline at end of file
@@ -92,4 +92,10 @@ namespace nldb {
         bool onlyRootCollection) {
         return repo->getAll(onlyRootCollection);
     }
-}  // namespace nldb
+
+    void CachedRepositoryCollection::clearCache() {
+        cache_find.clear();
+        cache_by_owner.clear();
+        cache_owner_id.clear();
+    }
+}  // namespace nldb
\ No newline at end of file
@@ -84,4 +84,6 @@ namespace nldb {
         snowflake collectionId) {
         return repo->findAll(collectionId);
     }
+
+    void CachedRepositoryProperty::clearCache() { cache.clear(); }
 }  // namespace nldb
\ No newline at end of file
@@ -1,11 +1,31 @@
 #include "nldb/Query/QueryPlanner.hpp"
 
+#include <fstream>
+#include <stdexcept>
+
 #include "nldb/typedef.hpp"
 
 namespace nldb {
     QueryPlanner::QueryPlanner(QueryPlannerContext&& ctx)
         : context(std::move(ctx)) {}
 
+    QueryPlannerWhere QueryPlanner::where(const PropertyExpression& expr) {
+        QueryPlannerContextWhere ctx(std::move(this->context));
+        ctx.where_value = expr;
+
+        return QueryPlannerWhere(std::move(ctx));
+    }
+
+    long long QueryPlanner::count() {
+        return QueryPlannerWhere(QueryPlannerContextWhere(std::move(context)))
+            .count();
+    }
+
+    bool QueryPlanner::exists() {
+        return QueryPlannerWhere(QueryPlannerContextWhere(std::move(context)))
+            .exists();
+    }
+
     std::vector<std::string> QueryPlanner::insert(const json& object) {
         QueryPlannerContextInsert ctx(std::move(this->context));
         ctx.documents = std::move(object);
@@ -13,6 +33,69 @@ namespace nldb {
         return ctx.queryRunner->insert(std::move(ctx));
     }
 
+    std::vector<std::string> QueryPlanner::insertRaw(
+        std::string_view documents) {
+        QueryPlannerContextInsertRaw ctx(std::move(this->context));
+        ctx.documents = documents;
+
+        return ctx.queryRunner->insertRaw(std::move(ctx));
+    }
+
+    LoadStats QueryPlanner::load(std::istream& input, int batchSize) {
+        QueryPlannerContextLoad ctx(std::move(this->context), input);
+        ctx.batchSize = batchSize;
+
+        return ctx.queryRunner->load(std::move(ctx));
+    }
+
+    LoadStats QueryPlanner::loadFile(const std::string& path, int batchSize) {
+        std::ifstream file(path);
+
+        if (!file) {
+            throw std::runtime_error("Could not open the file '" + path + "'");
+        }
+
+        return this->load(file, batchSize);
+    }
+
+    std::optional<json> QueryPlanner::get(snowflake docId) {
+        QueryPlannerContextGet ctx(std::move(this->context));
+        ctx.documentIDs = {docId};
+
+        json found = ctx.queryRunner->get(std::move(ctx));
+
+        if (found.empty()) return std::nullopt;
+
+        return std::move(found[0]);
+    }
+
+    std::optional<json> QueryPlanner::get(const std::string& docId) {
+        snowflake id;
+
+        try {
+            id = std::stoll(docId);
+        } catch (std::logic_error& e) {
+            throw std::runtime_error("invalid id");
+        }
+
+        return this->get(id);
+    }
+
+    json QueryPlanner::getMany(const std::vector<std::string>& docIds) {
+        QueryPlannerContextGet ctx(std::move(this->context));
+        ctx.documentIDs.reserve(docIds.size());
+
+        for (const auto& docId : docIds) {
+            try {
+                ctx.documentIDs.push_back(std::stoll(docId));
+            } catch (std::logic_error& e) {
+                throw std::runtime_error("invalid id");
+            }
+        }
+
+        return ctx.queryRunner->get(std::move(ctx));
+    }
+
     void QueryPlanner::update(snowflake docId, const json& newValue) {
         QueryPlannerContextUpdate ctx(std::move(this->context));
         ctx.documentID = docId;
@@ -51,4 +134,16 @@ namespace nldb {
 
         this->remove(id);
     }
+
+    void QueryPlanner::createIndex(const Property& property) {
+        QueryPlannerContextIndex ctx(std::move(this->context), property);
+
+        ctx.queryRunner->createIndex(std::move(ctx));
+    }
+
+    void QueryPlanner::dropIndex(const Property& property) {
+        QueryPlannerContextIndex ctx(std::move(this->context), property);
+
+        ctx.queryRunner->dropIndex(std::move(ctx));
+    }
 }  // namespace nldb
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "nldb/Query/QueryPlannerSelect.hpp"
 
+#include <stdexcept>
+
 #include "nldb/Property/Property.hpp"
 
 namespace nldb {
@@ -39,6 +41,50 @@ namespace nldb {
         return *this;
     }
 
+    /**
+     * @brief the tokens are the json array of the keys of a document
+     */
+    inline QueryKeyset ParsePageToken(const std::string& token, bool before) {
+        try {
+            json keys = json::parse(token);
+
+            if (keys.is_array() && !keys.empty()) {
+                return QueryKeyset {.keys = std::move(keys), .before = before};
+            }
+        } catch (const json::exception&) {
+        }
+
+        throw std::runtime_error("Invalid page token: " + token);
+    }
+
+    QueryPlannerSelect& QueryPlannerSelect::after(const std::string& token) {
+        this->context.keyset_value = ParsePageToken(token, false);
+        return *this;
+    }
+
+    QueryPlannerSelect& QueryPlannerSelect::after(const json& lastSortKeys,
+                                                  const std::string& lastId) {
+        snowflake id;
+
+        try {
+            id = std::stoll(lastId);
+        } catch (std::logic_error& e) {
+            throw std::runtime_error("invalid id");
+        }
+
+        json keys = lastSortKeys.is_array() ? lastSortKeys
+                                            : json::array({lastSortKeys});
+        keys.push_back(id);
+
+        this->context.keyset_value = QueryKeyset {.keys = std::move(keys)};
+        return *this;
+    }
+
+    QueryPlannerSelect& QueryPlannerSelect::before(const std::string& token) {
+        this->context.keyset_value = ParsePageToken(token, true);
+        return *this;
+    }
+
     QueryPlannerSelect& QueryPlannerSelect::includeInnerIds() {
         this->context.removeInnerIDs = false;
         return *this;
@@ -47,4 +93,13 @@ namespace nldb {
     json QueryPlannerSelect::execute() {
         return context.queryRunner->select(std::move(context));
     }
+
+    long long QueryPlannerSelect::stream(
+        const std::function<bool(json&)>& onDocument) {
+        return context.queryRunner->stream(std::move(context), onDocument);
+    }
+
+    SelectPage QueryPlannerSelect::executePage() {
+        return context.queryRunner->selectPage(std::move(context));
+    }
 }  // namespace nldb
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include "nldb/Query/QueryPlannerWhere.hpp"
+
+namespace nldb {
+    QueryPlannerWhere::QueryPlannerWhere(QueryPlannerContextWhere&& pContext)
+        : context(std::move(pContext)) {}
+
+    QueryPlannerWhere& QueryPlannerWhere::where(const PropertyExpression& val) {
+        if (this->context.where_value.has_value()) {
+            this->context.where_value =
+                PropertyExpression(PropertyExpressionOperator::AND, val,
+                                   this->context.where_value.value());
+        } else {
+            this->context.where_value = val;
+        }
+
+        return *this;
+    }
+
+    int QueryPlannerWhere::update(const json& newValue) {
+        QueryPlannerContextUpdateWhere ctx(std::move(this->context));
+        ctx.object = newValue;
+
+        return ctx.queryRunner->update(std::move(ctx));
+    }
+
+    int QueryPlannerWhere::remove() {
+        QueryPlannerContextRemoveWhere ctx(std::move(this->context));
+
+        return ctx.queryRunner->remove(std::move(ctx));
+    }
+
+    long long QueryPlannerWhere::count() {
+        QueryPlannerContextCountWhere ctx(std::move(this->context));
+
+        return ctx.queryRunner->count(std::move(ctx));
+    }
+
+    bool QueryPlannerWhere::exists() {
+        QueryPlannerContextCountWhere ctx(std::move(this->context));
+        ctx.onlyExists = true;
+
+        return ctx.queryRunner->count(std::move(ctx)) > 0;
+    }
+}  // namespace nldb
@@ -1,13 +1,21 @@
 #include "nldb/Query/QueryRunner.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_set>
 #include <variant>
+#include <vector>
 
 #include "magic_enum.hpp"
 #include "nldb/Collection.hpp"
@@ -19,6 +27,8 @@
 #include "nldb/Property/Property.hpp"
 #include "nldb/Property/SortedProperty.hpp"
 #include "nldb/Query/QueryContext.hpp"
+#include "nldb/Query/Transaction.hpp"
+#include "nldb/Query/UpdateOperator.hpp"
 #include "nldb/Utils/ParamsBindHelpers.hpp"
 #include "nldb/Utils/Variant.hpp"
 #include "nldb/nldb_json.hpp"
@@ -37,14 +47,18 @@ namespace nldb {
         {
             NLDB_PROFILE_FUNCTION();
 
-            std::lock_guard<std::mutex> lock(repos->mtx);
+            std::lock_guard<std::recursive_mutex> lock(repos->mtx);
 
             populateData<DoThrow>(data);
 
-            // check if doc exists
+            // check if doc exists, it could still be buffered
             snowflake& docID = data.documentID;
             if (!repos->valuesDAO->existsObject(docID)) {
-                throw DocumentNotFound("id: " + std::to_string(docID));
+                repos->pushPendingData();
+
+                if (!repos->valuesDAO->existsObject(docID)) {
+                    throw DocumentNotFound("id: " + std::to_string(docID));
+                }
             }
 
             // get the collection
@@ -52,7 +66,8 @@ namespace nldb {
 
             updateDocumentRecursive(docID, from, data.object);
 
-            repos->pushPendingData();
+            // the values are upserted, so they are buffered like the inserts
+            repos->schedulePendingData();
         }
 
         NLDB_PROFILE_END_SESSION();
@@ -66,7 +81,10 @@ namespace nldb {
         {
             NLDB_PROFILE_FUNCTION();
 
-            std::lock_guard<std::mutex> lock(repos->mtx);
+            // the documents are staged by this thread without holding the
+            // lock, it's only taken to find or add their collections and
+            // properties, and to merge them into the shared buffers
+            std::unique_lock<std::recursive_mutex> lock(repos->mtx);
 
             NLDB_ASSERT(data.from.size() > 0, "missing target collection");
 
@@ -78,6 +96,13 @@ namespace nldb {
 
             Collection& from = *data.from.begin();
 
+            SchemaMemo memo;
+            SchemaMemo::CollectionEntry& coll =
+                memoCollection(memo, from.getName());
+
+            std::optional<BufferData::Staging> staging = repos->stageValues();
+            if (staging) lock.unlock();
+
             if (data.documents.is_array()) {
                 ids.reserve(data.documents.size());
 
@@ -86,16 +111,21 @@ namespace nldb {
                     NLDB_TRACE("INSERTING {}", doc.dump(2));
 #endif
                     const snowflake insertedID =
-                        insertDocumentRecursive(doc, from.getName());
+                        insertDocumentRecursive(doc, coll);
                     ids.push_back(std::to_string(insertedID));
                 }
             } else {
                 const snowflake insertedID =
-                    insertDocumentRecursive(data.documents, from.getName());
+                    insertDocumentRecursive(data.documents, coll);
                 ids.push_back(std::to_string(insertedID));
             }
 
-            repos->pushPendingData();
+            if (staging) {
+                lock.lock();
+                staging->merge();
+            }
+
+            repos->schedulePendingData();
         }
 
         NLDB_PROFILE_END_SESSION();
@@ -103,13 +133,190 @@ namespace nldb {
     }
 
     void QueryRunner::remove(QueryPlannerContextRemove&& data) {
-        std::lock_guard<std::mutex> lock(repos->mtx);
+        std::lock_guard<std::recursive_mutex> lock(repos->mtx);
+
+        repos->pushPendingData();
 
         populateData<DoThrow>(data);
 
         repos->valuesDAO->removeObject(data.documentID);
     }
 
+    void QueryRunner::createIndex(QueryPlannerContextIndex&& data) {
+        std::lock_guard<std::recursive_mutex> lock(repos->mtx);
+
+        repos->pushPendingData();
+
+        populateData<DoThrow>(data.property);
+
+        repos->valuesDAO->createIndex(data.property.getId(),
+                                      data.property.getType());
+    }
+
+    void QueryRunner::dropIndex(QueryPlannerContextIndex&& data) {
+        std::lock_guard<std::recursive_mutex> lock(repos->mtx);
+
+        repos->pushPendingData();
+
+        populateData<DoThrow>(data.property);
+
+        repos->valuesDAO->dropIndex(data.property.getId(),
+                                    data.property.getType());
+    }
+
+    /**
+     * @brief Drops the indexes created by the user on the properties of a
+     * collection and its sub-collections, so a bulk load doesn't update them
+     * on every insert. They are kept as suspended in the database, which
+     * creates them again when opened if the load never restored them.
+     */
+    void SuspendIndexes(Repositories* repos, const std::string& collName) {
+        auto coll = repos->repositoryCollection->find(collName);
+
+        // a new collection has no indexes yet
+        if (!coll) return;
+
+        // the collection and its sub-collections, at any depth
+        std::unordered_set<snowflake> collections;
+        std::vector<snowflake> pending {coll->getId()};
+
+        while (!pending.empty()) {
+            const snowflake collID = pending.back();
+            pending.pop_back();
+
+            collections.insert(collID);
+
+            for (auto& prop : repos->repositoryProperty->findAll(collID)) {
+                if (prop.getType() != PropertyType::OBJECT) continue;
+
+                auto subColl =
+                    repos->repositoryCollection->findByOwner(prop.getId());
+                if (subColl) pending.push_back(subColl->getId());
+            }
+        }
+
+        for (snowflake propID : repos->valuesDAO->findIndexedProperties()) {
+            auto prop = repos->repositoryProperty->find(propID);
+
+            if (prop && collections.count(prop->getCollectionId())) {
+                repos->valuesDAO->suspendIndex(propID);
+            }
+        }
+    }
+
+    LoadStats QueryRunner::load(QueryPlannerContextLoad&& data) {
+        NLDB_ASSERT(data.from.size() > 0, "missing target collection");
+
+        const auto start = std::chrono::steady_clock::now();
+        const std::string collName = data.from.begin()->getName();
+        const size_t batchSize = std::max(data.batchSize, 1);
+
+        LoadStats stats;
+
+        std::vector<json> batch;
+        batch.reserve(batchSize);
+
+        auto insertBatch = [&]() {
+            // staged without the lock, like the insertions
+            std::optional<BufferData::Staging> staging = repos->stageValues();
+            std::unique_lock<std::recursive_mutex> lock(repos->mtx,
+                                                        std::defer_lock);
+            if (!staging) lock.lock();
+
+            SchemaMemo memo;
+            SchemaMemo::CollectionEntry& coll = memoCollection(memo, collName);
+
+            for (auto& doc : batch) insertDocumentRecursive(doc, coll);
+
+            if (staging) {
+                lock.lock();
+                staging->merge();
+            }
+
+            repos->schedulePendingData();
+
+            stats.documents += batch.size();
+            batch.clear();
+        };
+
+        auto addDocument = [&](json&& doc) {
+            if (!doc.is_object()) {
+                NLDB_WARN("Skipping a value that is not a document");
+                return;
+            }
+
+            batch.push_back(std::move(doc));
+
+            if (batch.size() >= batchSize) insertBatch();
+        };
+
+        {
+            std::lock_guard<std::recursive_mutex> lock(repos->mtx);
+            SuspendIndexes(repos.get(), collName);
+        }
+
+        try {
+            std::istream& input = data.input;
+            input >> std::ws;
+
+            if (input.peek() == '[') {
+                // take each document out of the array as soon as it's parsed,
+                // so the array is never built
+                auto takeDocument = [&addDocument](int depth,
+                                                   json::parse_event_t event,
+                                                   json& parsed) {
+                    const bool ended =
+                        event == json::parse_event_t::value ||
+                        event == json::parse_event_t::object_end ||
+                        event == json::parse_event_t::array_end;
+
+                    if (depth == 1 && ended) {
+                        addDocument(std::move(parsed));
+                        return false;
+                    }
+
+                    return true;
+                };
+
+                // only the empty array is left
+                [[maybe_unused]] json emptied =
+                    json::parse(input, takeDocument);
+            } else {
+                // newline delimited json, a document per line
+                std::string line;
+                while (std::getline(input, line)) {
+                    if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                        continue;
+                    }
+
+                    addDocument(json::parse(line));
+                }
+            }
+
+            if (!batch.empty()) insertBatch();
+        } catch (...) {
+            std::lock_guard<std::recursive_mutex> lock(repos->mtx);
+            repos->valuesDAO->restoreIndexes();
+            throw;
+        }
+
+        {
+            std::lock_guard<std::recursive_mutex> lock(repos->mtx);
+
+            repos->pushPendingData();
+            repos->valuesDAO->restoreIndexes();
+        }
+
+        stats.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+
+        NLDB_INFO("Loaded {} documents into '{}' in {} ms ({:.0f} documents/s)",
+                  stats.documents, collName, stats.elapsed.count(),
+                  stats.documentsPerSecond());
+
+        return stats;
+    }
+
     auto GetCollIdOrCreateIt(const std::string& collName, Repositories* repos,
                              std::optional<snowflake> pRootPropID) {
         snowflake newCollId = -1;
@@ -126,63 +333,53 @@ namespace nldb {
                              : repos->repositoryProperty->add(collName);
 
             newCollId = repos->repositoryCollection->add(collName, rootPropID);
+            repos->catalogChanged();
         }
 
         return std::array<snowflake, 2> {newCollId, rootPropID};
     }
 
-    inline auto getUserSpecifiedId(json& doc) {
+    inline std::optional<snowflake> parseUserSpecifiedId(const json& jsonID) {
         std::optional<snowflake> userSpecifiedID = std::nullopt;
-        if (doc.contains(internal_id_string)) {
-            auto& jsonID = doc[internal_id_string];
-            PropertyType type = JsonTypeToPropertyType((int)jsonID.type());
-            if (type == PropertyType::INTEGER) {
-                userSpecifiedID = doc[internal_id_string].get<snowflake>();
-            } else if (type == PropertyType::STRING) {
-                try {
-                    const std::string idStr =
-                        doc[internal_id_string].get<std::string>();
-
-                    // check if empty else it will fail.
-                    if (!idStr.empty()) {
-                        userSpecifiedID = std::stoll(idStr);
-                    }
 
-                    // if it's empty then continue as if no id was provided.
-                } catch (...) {
-                    NLDB_WARN("INVALID USER-SPECIFIED ID VALUE");
+        PropertyType type = JsonTypeToPropertyType((int)jsonID.type());
+        if (type == PropertyType::INTEGER) {
+            userSpecifiedID = jsonID.get<snowflake>();
+        } else if (type == PropertyType::STRING) {
+            try {
+                const std::string idStr = jsonID.get<std::string>();
+
+                // check if empty else it will fail.
+                if (!idStr.empty()) {
+                    userSpecifiedID = std::stoll(idStr);
                 }
-            } else {
-                NLDB_WARN(
-                    "INVALID USER-SPECIFIED ID TYPE (must be an integer or a "
-                    "string convertible to integer)");
+
+                // if it's empty then continue as if no id was provided.
+            } catch (...) {
+                NLDB_WARN("INVALID USER-SPECIFIED ID VALUE");
             }
+        } else {
+            NLDB_WARN(
+                "INVALID USER-SPECIFIED ID TYPE (must be an integer or a "
+                "string convertible to integer)");
         }
 
         return userSpecifiedID;
     }
 
-    snowflake QueryRunner::insertDocumentRecursive(
-        json& doc, const std::string& collName,
-        std::optional<snowflake> parentObjID,
-        std::optional<snowflake> pRootPropID) {
-        /**
-         * rootPropID explanation: imagine we are inserting into persona the
-         * object {name: "a", contact: {phone: 123}}, here we iterate
-         * through the name and contact properties, for "name" create a
-         * property of type string and for "contact" one of type object,
-         * that will be the parent property of the new collection
-         * "contact" that will be created in the next
-         * `insertDocumentRecursive` call, that is way we pass the new
-         * "contact" property to that function, so it knows the parent
-         * prop.
-         */
+    inline auto getUserSpecifiedId(json& doc) {
+        std::optional<snowflake> userSpecifiedID = std::nullopt;
+        if (doc.contains(internal_id_string)) {
+            userSpecifiedID = parseUserSpecifiedId(doc[internal_id_string]);
+        }
 
-        NLDB_PROFILE_FUNCTION();
+        return userSpecifiedID;
+    }
 
-        //  - Add the collection if missing
-        auto [collID, rootPropID] =
-            GetCollIdOrCreateIt(collName, repos.get(), pRootPropID);
+    snowflake QueryRunner::insertDocumentRecursive(
+        json& doc, SchemaMemo::CollectionEntry& coll,
+        std::optional<snowflake> parentObjID) {
+        NLDB_PROFILE_FUNCTION();
 
         // check if the document already has an id
         std::optional<snowflake> userSpecifiedID = getUserSpecifiedId(doc);
@@ -191,13 +388,13 @@ namespace nldb {
         snowflake objID =
             userSpecifiedID.has_value()
                 ? repos->valuesDAO->addObjectWithID(userSpecifiedID.value(),
-                                                    rootPropID, parentObjID)
-                : repos->valuesDAO->addObject(rootPropID, parentObjID);
+                                                    coll.rootPropID,
+                                                    parentObjID)
+                : repos->valuesDAO->addObject(coll.rootPropID, parentObjID);
 
         for (auto& [propertyName, value] : doc.items()) {
             if (propertyName == internal_id_string) continue;
 
-            snowflake propID = -1;
             PropertyType type = JsonTypeToPropertyType((int)value.type());
 
             // skip null values, because if we set it to null then the cannot
@@ -205,49 +402,567 @@ namespace nldb {
             if (type == PropertyType::_NULL) continue;
 
             //  - Create missing collection properties
-            if (auto prop =
-                    repos->repositoryProperty->find(collID, propertyName)) {
-                const PropertyType storedType = prop->getType();
+            SchemaMemo::PropertyEntry& prop =
+                memoProperty(coll, propertyName, type);
+
+            if (type == PropertyType::OBJECT) {
+                //  - if property.type is Object
+                //      - create a sub-collection and add a document/object
+                //      - repeat the steps from the start
+
+                this->insertDocumentRecursive(
+                    value, memoSubCollection(coll, propertyName, prop), objID);
+            } else {
+                addValue(prop.id, objID, type, value);
+            }
+        }
 
-                if (storedType != type
-                    // Always allow integers into doubles, we do not lose data.
-                    && !(storedType == DOUBLE && type == INTEGER)
+        return objID;
+    }
+
+    /**
+     * @brief throws if a value of `type` cannot be stored in the property,
+     * else sets `type` to the stored type.
+     */
+    inline void CheckStoredType(const std::string& propertyName,
+                                PropertyType storedType, PropertyType& type) {
+        if (storedType != type
+            // Always allow integers into doubles, we do not lose data.
+            && !(storedType == DOUBLE && type == INTEGER)
 #if NLDB_ENABLE_DOUBLE_DOWNCASTING
-                    // Possible data loss, check the configuration
-                    && !(storedType == INTEGER && type == DOUBLE)
+            // Possible data loss, check the configuration
+            && !(storedType == INTEGER && type == DOUBLE)
 #endif
-                ) {
-                    throw WrongPropertyType(
-                        propertyName,
-                        std::string(magic_enum::enum_name(storedType)),
-                        std::string(magic_enum::enum_name(type)));
+        ) {
+            throw WrongPropertyType(
+                propertyName, std::string(magic_enum::enum_name(storedType)),
+                std::string(magic_enum::enum_name(type)));
+        }
+
+        // if a "logic conversion" took place, force the type to behave as the
+        // stored type.
+        type = storedType;
+    }
+
+    snowflake QueryRunner::findOrAddProperty(snowflake collID,
+                                             const std::string& propertyName,
+                                             PropertyType& type) {
+        auto prop = repos->repositoryProperty->find(collID, propertyName);
+
+        if (!prop) {
+            const snowflake id =
+                repos->repositoryProperty->add(propertyName, collID, type);
+            repos->catalogChanged();
+
+            return id;
+        }
+
+        CheckStoredType(propertyName, prop->getType(), type);
+
+        return prop->getId();
+    }
+
+    snowflake QueryRunner::findOrAddOperatorProperty(
+        snowflake collID, const std::string& propertyName, const json& operand,
+        PropertyType& type) {
+        type = JsonTypeToPropertyType((int)operand.type());
+
+        if (type != PropertyType::INTEGER && type != PropertyType::DOUBLE) {
+            throw WrongPropertyType(propertyName, "INTEGER or DOUBLE",
+                                    std::string(magic_enum::enum_name(type)));
+        }
+
+        const uint64_t catalogVersion = repos->getCatalogVersion();
+        const snowflake propID = findOrAddProperty(collID, propertyName, type);
+
+        // the operators write the value without the buffers, so a property
+        // that was just buffered is written before it
+        if (repos->getCatalogVersion() != catalogVersion) {
+            repos->pushPendingData();
+        }
+
+        return propID;
+    }
+
+    void QueryRunner::applyUpdateOperators(snowflake objID,
+                                           const Collection& collection,
+                                           const std::string& propertyName,
+                                           json& operators) {
+        for (auto& [key, operand] : operators.items()) {
+            const UpdateOperator op = FindUpdateOperator(key).value();
+
+            PropertyType type;
+            const snowflake propID = findOrAddOperatorProperty(
+                collection.getId(), propertyName, operand, type);
+
+            if (type == PropertyType::INTEGER) {
+                repos->valuesDAO->applyIntegerOperator(propID, objID, op,
+                                                       operand.get<int64_t>());
+            } else {
+                repos->valuesDAO->applyDoubleOperator(propID, objID, op,
+                                                      operand.get<double>());
+            }
+        }
+    }
+
+    SchemaMemo::CollectionEntry& QueryRunner::memoCollection(
+        SchemaMemo& memo, const std::string& collName) {
+        auto it = memo.collections.find(collName);
+
+        if (it == memo.collections.end()) {
+            std::lock_guard<std::recursive_mutex> lock(repos->mtx);
+
+            //  - Add the collection if missing
+            auto [collID, rootPropID] =
+                GetCollIdOrCreateIt(collName, repos.get(), std::nullopt);
+
+            it = memo.collections
+                     .emplace(collName, SchemaMemo::CollectionEntry {
+                                            .name = collName,
+                                            .id = collID,
+                                            .rootPropID = rootPropID})
+                     .first;
+        }
+
+        return it->second;
+    }
+
+    SchemaMemo::PropertyEntry& QueryRunner::memoProperty(
+        SchemaMemo::CollectionEntry& coll, const std::string& propertyName,
+        PropertyType& type) {
+        auto it = coll.properties.find(propertyName);
+
+        if (it != coll.properties.end()) {
+            CheckStoredType(propertyName, it->second.type, type);
+            return it->second;
+        }
+
+        std::lock_guard<std::recursive_mutex> lock(repos->mtx);
+
+        const snowflake propID = findOrAddProperty(coll.id, propertyName, type);
+
+        return coll.properties
+            .emplace(propertyName,
+                     SchemaMemo::PropertyEntry {.id = propID, .type = type})
+            .first->second;
+    }
+
+    SchemaMemo::CollectionEntry& QueryRunner::memoSubCollection(
+        SchemaMemo::CollectionEntry& coll, const std::string& propertyName,
+        SchemaMemo::PropertyEntry& prop) {
+        /**
+         * imagine we are inserting into persona the object {name: "a",
+         * contact: {phone: 123}}, for "contact" we create a property of type
+         * object, that will be the parent property of the new collection
+         * "contact", that is why we pass it when adding the collection.
+         */
+        if (!prop.subCollection) {
+            std::string name = getSubCollectionName(coll.name, propertyName);
+
+            std::lock_guard<std::recursive_mutex> lock(repos->mtx);
+            auto [collID, rootPropID] =
+                GetCollIdOrCreateIt(name, repos.get(), prop.id);
+
+            prop.subCollection = std::make_unique<SchemaMemo::CollectionEntry>(
+                SchemaMemo::CollectionEntry {.name = std::move(name),
+                                             .id = collID,
+                                             .rootPropID = rootPropID});
+        }
+
+        return *prop.subCollection;
+    }
+
+    void QueryRunner::addValue(snowflake propID, snowflake objID,
+                               PropertyType type, json& value) {
+        switch (type) {
+            case PropertyType::INTEGER:
+                repos->valuesDAO->addInteger(propID, objID,
+                                             value.get<int64_t>());
+                break;
+            case PropertyType::BOOLEAN:
+                repos->valuesDAO->addInteger(propID, objID,
+                                             value.get<bool>() ? 1 : 0);
+                break;
+            case PropertyType::DOUBLE:
+                repos->valuesDAO->addDouble(propID, objID, value.get<double>());
+                break;
+            default: {
+                ValueText text;
+                repos->valuesDAO->addStringLike(propID, objID, type,
+                                                ValueToStringView(value, text));
+            }
+        }
+    }
+
+    void QueryRunner::upsertValue(snowflake propID, snowflake objID,
+                                  PropertyType type, json& value) {
+        switch (type) {
+            case PropertyType::INTEGER:
+                repos->valuesDAO->upsertInteger(propID, objID,
+                                                value.get<int64_t>());
+                break;
+            case PropertyType::BOOLEAN:
+                repos->valuesDAO->upsertInteger(propID, objID,
+                                                value.get<bool>() ? 1 : 0);
+                break;
+            case PropertyType::DOUBLE:
+                repos->valuesDAO->upsertDouble(propID, objID,
+                                               value.get<double>());
+                break;
+            default: {
+                ValueText text;
+                repos->valuesDAO->upsertStringLike(
+                    propID, objID, type, ValueToStringView(value, text));
+            }
+        }
+    }
+
+    /**
+     * @brief Inserts the documents of a json text while it's parsed, from the
+     * events of the sax parser instead of walking a json object.
+     *
+     * The values of a document are added once its id is known, that is when
+     * its `_id` is found or when it's clear that it doesn't have one: at its
+     * first sub-document or at its end. Arrays are stored as text, so they
+     * are the only values built as json.
+     */
+    class DocumentSaxInserter {
+       public:
+        DocumentSaxInserter(QueryRunner& pRunner, std::string pCollName)
+            : runner(pRunner),
+              repos(pRunner.repos.get()),
+              collName(std::move(pCollName)) {}
+
+        bool null() {
+            if (!building.empty()) return addToBuilding(nullptr);
+
+            // skip null values, same as when inserting a json object
+            return true;
+        }
+
+        bool boolean(bool val) { return scalar(PropertyType::BOOLEAN, val); }
+
+        bool number_integer(json::number_integer_t val) {
+            return scalar(PropertyType::INTEGER, (int64_t)val);
+        }
+
+        bool number_unsigned(json::number_unsigned_t val) {
+            // integers are stored signed, don't let it wrap
+            if (val > (json::number_unsigned_t)INT64_MAX) {
+                throw std::runtime_error("Integer out of range: " +
+                                         std::to_string(val));
+            }
+
+            return scalar(PropertyType::INTEGER, (int64_t)val);
+        }
+
+        bool number_float(json::number_float_t val, const json::string_t&) {
+            return scalar(PropertyType::DOUBLE, (double)val);
+        }
+
+        bool string(json::string_t& val) {
+            return scalar(PropertyType::STRING, std::move(val));
+        }
+
+        bool binary(json::binary_t&) {
+            throw std::runtime_error("Binary values are not supported");
+        }
+
+        bool start_object(std::size_t) {
+            if (!building.empty() || (!frames.empty() && isIdKey())) {
+                building.emplace_back(json::object(), "");
+                return true;
+            }
+
+            if (frames.empty()) {
+                pushDocument(runner.memoCollection(memo, collName),
+                             std::nullopt);
+                return true;
+            }
+
+            // a sub-document of the current property
+            Frame& parent = frames.back();
+
+            PropertyType type = PropertyType::OBJECT;
+            SchemaMemo::PropertyEntry& prop =
+                runner.memoProperty(*parent.coll, parent.key, type);
+
+            const snowflake parentObjID = createObject(parent);
+
+            pushDocument(
+                runner.memoSubCollection(*parent.coll, parent.key, prop),
+                parentObjID);
+
+            return true;
+        }
+
+        bool key(json::string_t& val) {
+            if (!building.empty()) {
+                building.back().second = std::move(val);
+            } else {
+                frames.back().key = std::move(val);
+            }
+
+            return true;
+        }
+
+        bool end_object() {
+            if (!building.empty()) return endBuilding();
+
+            const snowflake objID = createObject(frames.back());
+            frames.pop_back();
+
+            if (frames.empty()) ids.push_back(std::to_string(objID));
+
+            return true;
+        }
+
+        bool start_array(std::size_t) {
+            if (frames.empty() && building.empty()) {
+                if (inDocumentList) {
+                    throw std::runtime_error("Expected a document");
                 }
 
-                // if a "logic conversion" took place, force the type to behave
-                // as the stored type.
-                type = storedType;
+                // a list of documents
+                inDocumentList = true;
+                return true;
+            }
+
+            building.emplace_back(json::array(), "");
+            return true;
+        }
+
+        bool end_array() {
+            if (!building.empty()) return endBuilding();
+
+            // end of the list of documents
+            return true;
+        }
+
+        bool parse_error(std::size_t, const std::string&,
+                         const json::exception& ex) {
+            if (ex.id / 100 == 1) {
+                throw static_cast<const json::parse_error&>(ex);
+            }
+
+            throw std::runtime_error(ex.what());
+        }
+
+       public:
+        // ids of the top level documents, in the order they were inserted
+        std::vector<std::string> ids;
+
+       private:
+        using Scalar = std::variant<int64_t, double, bool, std::string>;
+
+        struct PendingValue {
+            snowflake propID;
+            PropertyType type;
+            Scalar value;
+        };
+
+        struct Frame {
+            SchemaMemo::CollectionEntry* coll {nullptr};
+            std::optional<snowflake> parentObjID {};
+            std::optional<snowflake> objID {};
+            std::optional<snowflake> userSpecifiedID {};
+
+            // property of the next value
+            std::string key {};
+
+            // values waiting for the object to be created
+            std::vector<PendingValue> pending {};
+        };
+
+        bool isIdKey() { return frames.back().key == internal_id_string; }
+
+        void pushDocument(SchemaMemo::CollectionEntry& coll,
+                          std::optional<snowflake> parentObjID) {
+            frames.push_back(Frame {.coll = &coll, .parentObjID = parentObjID});
+        }
+
+        snowflake createObject(Frame& frame) {
+            if (frame.objID) return frame.objID.value();
+
+            frame.objID =
+                frame.userSpecifiedID.has_value()
+                    ? repos->valuesDAO->addObjectWithID(
+                          frame.userSpecifiedID.value(),
+                          frame.coll->rootPropID, frame.parentObjID)
+                    : repos->valuesDAO->addObject(frame.coll->rootPropID,
+                                                  frame.parentObjID);
+
+            for (auto& val : frame.pending) {
+                addScalar(val.propID, frame.objID.value(), val.type, val.value);
+            }
+
+            frame.pending.clear();
+
+            return frame.objID.value();
+        }
+
+        bool scalar(PropertyType type, Scalar val) {
+            if (!building.empty()) {
+                std::visit([this](auto& v) { addToBuilding(std::move(v)); },
+                           val);
+                return true;
+            }
 
-                propID = prop->getId();
+            if (frames.empty()) throw std::runtime_error("Expected a document");
+
+            Frame& frame = frames.back();
+
+            if (isIdKey()) {
+                if (frame.objID) {
+                    throw std::runtime_error(
+                        "The id of a document must come before its "
+                        "sub-documents");
+                }
+
+                frame.userSpecifiedID = std::visit(
+                    [](auto& v) { return parseUserSpecifiedId(json(v)); }, val);
+
+                return true;
+            }
+
+            addProperty(frame, type, std::move(val));
+
+            return true;
+        }
+
+        void addProperty(Frame& frame, PropertyType type, Scalar val) {
+            const snowflake propID =
+                runner.memoProperty(*frame.coll, frame.key, type).id;
+
+            if (frame.objID) {
+                addScalar(propID, frame.objID.value(), type, val);
             } else {
-                propID =
-                    repos->repositoryProperty->add(propertyName, collID, type);
+                frame.pending.push_back(
+                    PendingValue {propID, type, std::move(val)});
             }
+        }
 
-            if (type == PropertyType::OBJECT) {
-                //  - if property.type is Object
-                //      - create a sub-collection and add a document/object
-                //      - repeat the steps from the start
+        void addScalar(snowflake propID, snowflake objID, PropertyType type,
+                       Scalar& val) {
+            switch (type) {
+                case PropertyType::INTEGER:
+                case PropertyType::BOOLEAN:
+                    repos->valuesDAO->addInteger(propID, objID,
+                                                 numberAs<int64_t>(val));
+                    break;
+                case PropertyType::DOUBLE:
+                    repos->valuesDAO->addDouble(propID, objID,
+                                                numberAs<double>(val));
+                    break;
+                default:
+                    repos->valuesDAO->addStringLike(
+                        propID, objID, type, std::get<std::string>(val));
+            }
+        }
 
-                this->insertDocumentRecursive(
-                    value, getSubCollectionName(collName, propertyName), objID,
-                    propID);
+        template <typename N>
+        static N numberAs(const Scalar& val) {
+            return std::visit(
+                [](auto& v) -> N {
+                    using V = std::decay_t<decltype(v)>;
+
+                    if constexpr (std::is_arithmetic_v<V>) {
+                        return static_cast<N>(v);
+                    } else {
+                        throw std::runtime_error("Expected a number");
+                    }
+                },
+                val);
+        }
+
+        bool addToBuilding(json val) {
+            auto& [container, key] = building.back();
+
+            if (container.is_array()) {
+                container.push_back(std::move(val));
             } else {
-                repos->valuesDAO->addStringLike(propID, objID, type,
-                                                ValueToString(value));
+                container[key] = std::move(val);
             }
+
+            return true;
         }
 
-        return objID;
+        bool endBuilding() {
+            json done = std::move(building.back().first);
+            building.pop_back();
+
+            if (!building.empty()) return addToBuilding(std::move(done));
+
+            Frame& frame = frames.back();
+
+            if (isIdKey()) {
+                // not a valid id, it warns about it
+                frame.userSpecifiedID = parseUserSpecifiedId(done);
+            } else {
+                addProperty(frame, PropertyType::ARRAY, done.dump());
+            }
+
+            return true;
+        }
+
+       private:
+        QueryRunner& runner;
+        Repositories* repos;
+        std::string collName;
+
+        // collections and properties found so far
+        SchemaMemo memo;
+
+        // documents being inserted, the last one is the innermost
+        std::vector<Frame> frames;
+
+        // arrays being built, with objects or arrays inside them, and the key
+        // of their next value if they are an object
+        std::vector<std::pair<json, std::string>> building;
+
+        bool inDocumentList {false};
+    };
+
+    std::vector<std::string> QueryRunner::insertRaw(
+        QueryPlannerContextInsertRaw&& data) {
+        NLDB_PROFILE_BEGIN_SESSION("insert", "nldb-profile-insert.json");
+        std::vector<std::string> ids;
+
+        {
+            NLDB_PROFILE_FUNCTION();
+
+            std::lock_guard<std::recursive_mutex> lock(repos->mtx);
+
+            NLDB_ASSERT(data.from.size() > 0, "missing target collection");
+
+            // a text that fails halfway shouldn't leave the documents parsed
+            // until then, so it's inserted in its own transaction. If the
+            // user has one open, it's up to them to roll it back.
+            repos->pushPendingData();
+            repos->commitPendingData();
+
+            std::optional<Transaction> transaction;
+            if (!connection->isInTransaction()) {
+                transaction.emplace(connection, repos);
+            }
+
+            populateData<DoNotThrow>(data);
+
+            DocumentSaxInserter inserter(*this, data.from.begin()->getName());
+            json::sax_parse(data.documents.begin(), data.documents.end(),
+                            &inserter);
+
+            ids = std::move(inserter.ids);
+
+            if (transaction) {
+                transaction->commit();
+            } else {
+                repos->schedulePendingData();
+            }
+        }
+
+        NLDB_PROFILE_END_SESSION();
+        return ids;
     }
 
     void QueryRunner::updateDocumentRecursive(snowflake objID,
@@ -257,6 +972,11 @@ namespace nldb {
         for (auto& [propName, valueJson] : object.items()) {
             if (propName == internal_id_string) continue;
 
+            if (IsUpdateOperation(valueJson)) {
+                applyUpdateOperators(objID, collection, propName, valueJson);
+                continue;
+            }
+
             std::optional<Property> found =
                 repos->repositoryProperty->find(collection.getId(), propName);
 
@@ -268,49 +988,31 @@ namespace nldb {
             snowflake propID;
 
             if (found.has_value()) {
-                const PropertyType storedType = found->getType();
-
-                if (storedType != type
-                    // Always allow integers into doubles, we do not lose data.
-                    && !(storedType == DOUBLE && type == INTEGER)
-#if NLDB_ENABLE_DOUBLE_DOWNCASTING
-                    // Possible data loss, check the configuration
-                    && !(storedType == INTEGER && type == DOUBLE)
-#endif
-                ) {
-                    throw WrongPropertyType(
-                        propName,
-                        std::string(magic_enum::enum_name(storedType)),
-                        std::string(magic_enum::enum_name(type)));
-                }
-
-                // if a "logic conversion" took place, force the type to behave
-                // as the stored type.
-                type = storedType;
+                CheckStoredType(propName, found->getType(), type);
 
                 propID = found->getId();
             } else {
                 propID = repos->repositoryProperty->add(
                     propName, collection.getId(), type);
+                repos->catalogChanged();
             }
 
             if (type != PropertyType::OBJECT) {
-                std::string valueString = ValueToString(valueJson);
-
                 // update the value or create a new one
-                if (repos->valuesDAO->exists(propID, objID, type)) {
-                    repos->valuesDAO->updateStringLike(propID, objID, type,
-                                                       valueString);
-                } else {
-                    repos->valuesDAO->addStringLike(propID, objID, type,
-                                                    valueString);
-                }
+                upsertValue(propID, objID, type, valueJson);
             } else {
                 // If this document has this object, then update that
                 // sub-document. Else a new value object should be added.
 
                 auto childObjectID =
                     repos->valuesDAO->findObjectId(propID, objID);
+
+                if (!childObjectID.has_value()) {
+                    // it could still be buffered
+                    repos->pushPendingData();
+                    childObjectID =
+                        repos->valuesDAO->findObjectId(propID, objID);
+                }
                 if (childObjectID.has_value()) {
                     auto chilCollection =
                         repos->repositoryCollection->findByOwner(propID);
@@ -0,0 +1,75 @@
+#include "nldb/Query/Transaction.hpp"
+
+#include <stdexcept>
+
+#include "nldb/LOG/log.hpp"
+
+namespace nldb {
+    Transaction::Transaction(IDB* pConnection,
+                             std::shared_ptr<Repositories> pRepos)
+        : connection(pConnection), repos(std::move(pRepos)), lock(repos->mtx) {
+        // what was buffered before is not part of this transaction
+        repos->pushPendingData();
+        repos->commitPendingData();
+
+        if (connection->isInTransaction()) {
+            throw std::runtime_error("Nested transactions are not supported");
+        }
+
+        connection->begin();
+        active = true;
+    }
+
+    void Transaction::commit() {
+        if (!active) {
+            throw std::runtime_error("The transaction already finished");
+        }
+
+        try {
+            repos->pushPendingData();
+            connection->commit();
+        } catch (...) {
+            rollback();
+            throw;
+        }
+
+        finish();
+    }
+
+    void Transaction::rollback() {
+        if (!active) return;
+
+        repos->discardPendingData();
+
+        // finish even if it fails, the connection might have already ended it
+        try {
+            if (connection->isInTransaction()) connection->rollback();
+        } catch (...) {
+            repos->clearCaches();
+            finish();
+            throw;
+        }
+
+        // they could have the collections and properties that were added
+        repos->clearCaches();
+
+        finish();
+    }
+
+    bool Transaction::isActive() const { return active; }
+
+    void Transaction::finish() {
+        active = false;
+        lock.unlock();
+    }
+
+    Transaction::~Transaction() {
+        if (!active) return;
+
+        try {
+            rollback();
+        } catch (const std::exception& e) {
+            NLDB_ERROR("Couldn't rollback the transaction: {}", e.what());
+        }
+    }
+}  // namespace nldb
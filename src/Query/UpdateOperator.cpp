@@ -0,0 +1,29 @@
+#include "nldb/Query/UpdateOperator.hpp"
+
+#include "nldb/Exceptions.hpp"
+
+namespace nldb {
+    std::optional<UpdateOperator> FindUpdateOperator(const std::string& key) {
+        if (key == "$inc") return UpdateOperator::INCREMENT;
+        if (key == "$min") return UpdateOperator::MINIMUM;
+        if (key == "$max") return UpdateOperator::MAXIMUM;
+
+        return std::nullopt;
+    }
+
+    bool IsUpdateOperation(const json& value) {
+        if (!value.is_object() || value.empty()) return false;
+
+        int operators = 0;
+        for (auto& [key, operand] : value.items()) {
+            if (FindUpdateOperator(key)) operators++;
+        }
+
+        if (operators > 0 && operators != (int)value.size()) {
+            throw InvalidUpdate(
+                "operators can't be mixed with properties: " + value.dump());
+        }
+
+        return operators > 0;
+    }
+}  // namespace nldb
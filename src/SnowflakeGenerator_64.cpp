@@ -3,30 +3,45 @@
 /**
  * 64 bit long snowflake implementation
  *
+ * | 43 bits timestamp in ms | 21 bits sequence |
+ *
+ * (2^(43-1)-1)/(ms per year) = 139 years, and 2^21 ids per ms between all
+ * the threads before the sequence borrows from the next ms.
  */
 
 namespace nldb {
-    constexpr int MAX_THREADS = 127;  // 2^7 -1
+    std::atomic<snowflake> SnowflakeGenerator::nextFree {0};
+
+    namespace {
+        struct ReservedBlock {
+            snowflake next {0};
+            snowflake end {0};
+        };
 
-    // constexpr int timestampBits = 43;  // (2^(43-1)-1)/(ms per year) = 139
-    // years
-    constexpr int counterBits = 14;  // 2^14 = 16383
-    constexpr int threadIdBits = 7;  // 2^7 = 127
+        thread_local ReservedBlock reserved;
+    }  // namespace
 
-    static std::array<int, MAX_THREADS> counter_thread = {0};
+    snowflake SnowflakeGenerator::generate() {
+        if (reserved.next == reserved.end) {
+            reserved.next = reserveBlock();
+            reserved.end = reserved.next + blockSize;
+        }
 
-    snowflake SnowflakeGenerator::generate(uint16_t threadID) {
-        if (threadID > MAX_THREADS)
-            throw std::runtime_error("invalid thread id");
+        return reserved.next++;
+    }
 
-        snowflake snowflake = getCurrentTimestampMs();
+    snowflake SnowflakeGenerator::reserveBlock() {
+        const snowflake now = getCurrentTimestampMs() << sequenceBits;
 
-        snowflake <<= threadIdBits;
-        snowflake <<= counterBits;
+        snowflake start = nextFree.load(std::memory_order_relaxed);
+        snowflake first;
 
-        snowflake |= ++counter_thread[threadID] << threadIdBits;
-        snowflake |= threadID;
+        do {
+            // if the counter fell behind the clock, move it forward
+            first = start < now ? now : start;
+        } while (!nextFree.compare_exchange_weak(start, first + blockSize,
+                                                 std::memory_order_relaxed));
 
-        return snowflake;
+        return first;
     }
-}  // namespace nldb
\ No newline at end of file
+}  // namespace nldb
@@ -1,141 +1,218 @@
 #include "nldb/backends/sqlite3/DAL/BufferDataSQ3.hpp"
 
-#include <map>
-#include <sstream>
+#include <algorithm>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
 #include "nldb/LOG/log.hpp"
 #include "nldb/Profiling/Profiler.hpp"
 #include "nldb/Property/Property.hpp"
-#include "nldb/Utils/ParamsBindHelpers.hpp"
-#include "nldb/backends/sqlite3/DAL//Definitions.hpp"
+#include "nldb/backends/sqlite3/DAL/Definitions.hpp"
 
 namespace nldb {
     using namespace definitions;
 
-    BufferDataSQ3::BufferDataSQ3(IDB* db, int SmallBufferSize,
-                                 int MediumBufferSize, int LargeBufferSize)
-        : BufferData(db, SmallBufferSize, MediumBufferSize, LargeBufferSize) {}
+    // values replace the one the object has for the property, if any
+    static const std::string upsertValue =
+        " on conflict (obj_id, prop_id) do update set value = excluded.value";
+
+    /**
+     * @brief Inserts rows with prepared multi-row inserts, binding their
+     * values instead of writing them in the sql. The rows are inserted in
+     * chunks of as many rows as parameters a statement can have and the ones
+     * that don't fill a chunk are inserted one by one, so only two statements
+     * are prepared for each table and both get reused between flushes.
+     */
+    class RowsInserter {
+       public:
+        /**
+         * @param db
+         * @param head insert up to the values, e.g. "insert into t (a, b)"
+         * @param columns number of values of each row
+         * @param rows number of rows that will be inserted
+         * @param tail sql after the values, e.g. an upsert clause
+         */
+        RowsInserter(DBSL3* pDb, std::string pHead, int pColumns, int pRows,
+                     std::string pTail = "")
+            : db(pDb),
+              head(std::move(pHead)),
+              tail(std::move(pTail)),
+              columns(pColumns),
+              remaining(pRows) {
+            rowsPerChunk =
+                std::clamp(db->getMaxBoundParameters() / columns, 1,
+                           max_sql3_rows_per_insert);
+        }
 
-    void BufferDataSQ3::pushRootProperties() {
-        NLDB_PROFILE_FUNCTION();
+        /**
+         * @brief Inserts the next row.
+         *
+         * @param bindRow binds the row values, e.g.
+         * [](DBStatementSL3& stmt, int first) { stmt.bind(first, a); ...}
+         */
+        template <typename F>
+        void insert(const F& bindRow) {
+            if (current == nullptr) {
+                if (remaining >= rowsPerChunk) {
+                    if (!chunk) chunk.emplace(db->prepare(sql(rowsPerChunk)));
+                    current = &chunk.value();
+                    currentRows = rowsPerChunk;
+                } else {
+                    if (!single) single.emplace(db->prepare(sql(1)));
+                    current = &single.value();
+                    currentRows = 1;
+                }
+            }
 
-        std::stringstream root_prop_sql;
-        root_prop_sql << "insert into property (id, name, type) values ";
+            bindRow(*current, row * columns + 1);
 
-        bufferRootProperty.ForEach(
-            [&root_prop_sql](BufferValueRootProperty& val, bool isLast) {
-                root_prop_sql << "(" << val.id << ", "
-                              << utils::paramsbind::encloseQuotesConst(val.name)
-                              << ", " << (int)PropertyType::OBJECT << ")"
-                              << (isLast ? ";" : ",");
-            });
+            row++;
+            remaining--;
 
-        const std::string root_prop_str = std::move(root_prop_sql).str();
+            if (row == currentRows) {
+                current->execute();
+                current = nullptr;
+                row = 0;
+            }
+        }
 
-        conn->execute(root_prop_str, {});
+       private:
+        std::string sql(int rows) {
+            std::string values = "(?";
+            for (int i = 1; i < columns; i++) values += ",?";
+            values += ")";
 
-        bufferRootProperty.Reset();
-    }
+            std::string sql = head + " values " + values;
+            sql.reserve(sql.size() + (values.size() + 1) * rows);
 
-    void BufferDataSQ3::pushCollections() {
+            for (int i = 1; i < rows; i++) {
+                sql += ",";
+                sql += values;
+            }
+
+            return sql + tail + ";";
+        }
+
+       private:
+        DBSL3* db;
+        std::string head;
+        std::string tail;
+        int columns;
+        int remaining;
+        int rowsPerChunk;
+
+        std::optional<DBStatementSL3> chunk;
+        std::optional<DBStatementSL3> single;
+
+        DBStatementSL3* current {nullptr};
+        int currentRows {0};
+        int row {0};
+    };
+
+    BufferDataSQ3::BufferDataSQ3(DBSL3* db, int SmallBufferSize,
+                                 int MediumBufferSize, int LargeBufferSize,
+                                 int FlushesPerCommit, int CommitMaxDelayMs)
+        : BufferData(db, SmallBufferSize, MediumBufferSize, LargeBufferSize,
+                     FlushesPerCommit, CommitMaxDelayMs),
+          sq3Conn(db) {}
+
+    void BufferDataSQ3::pushRootProperties() {
         NLDB_PROFILE_FUNCTION();
 
-        std::stringstream coll_sql;
-        coll_sql << "insert into collection (id, name, owner_id) values ";
+        RowsInserter inserter(sq3Conn, "insert into property (id, name, type)",
+                              3, bufferRootProperty.FrozenSize());
 
-        bufferCollection.ForEach(
-            [&coll_sql](BufferValueCollection& val, bool isLast) {
-                coll_sql << "(" << val.id << ", "
-                         << utils::paramsbind::encloseQuotesConst(val.name)
-                         << ", " << val.owner_id << ")" << (isLast ? ";" : ",");
+        bufferRootProperty.ForEachFrozen(
+            [&inserter](BufferValueRootProperty& val, bool) {
+                inserter.insert([&val](DBStatementSL3& stmt, int i) {
+                    stmt.bind(i, val.id);
+                    stmt.bind(i + 1, val.name);
+                    stmt.bind(i + 2, (int64_t)PropertyType::OBJECT);
+                });
             });
 
-        const std::string coll_sql_str = std::move(coll_sql).str();
+        bufferRootProperty.ReleaseFrozen();
+    }
 
-        conn->execute(coll_sql_str, {});
+    void BufferDataSQ3::pushCollections() {
+        NLDB_PROFILE_FUNCTION();
+
+        RowsInserter inserter(sq3Conn,
+                              "insert into collection (id, name, owner_id)", 3,
+                              bufferCollection.FrozenSize());
+
+        bufferCollection.ForEachFrozen(
+            [&inserter](BufferValueCollection& val, bool) {
+                inserter.insert([&val](DBStatementSL3& stmt, int i) {
+                    stmt.bind(i, val.id);
+                    stmt.bind(i + 1, val.name);
+                    stmt.bind(i + 2, val.owner_id);
+                });
+            });
 
-        bufferCollection.Reset();
+        bufferCollection.ReleaseFrozen();
     }
 
     void BufferDataSQ3::pushProperties() {
         NLDB_PROFILE_FUNCTION();
 
-        std::stringstream prop_sql;
-        prop_sql << "insert into property (id, name, type, coll_id) values ";
-
-        bufferProperty.ForEach(
-            [&prop_sql](BufferValueProperty& val, bool isLast) {
-                prop_sql << "(" << val.id << ", "
-                         << utils::paramsbind::encloseQuotesConst(val.name)
-                         << ", " << (int)val.type << "," << val.coll_id << ")"
-                         << (isLast ? ";" : ",");
+        RowsInserter inserter(
+            sq3Conn, "insert into property (id, name, type, coll_id)", 4,
+            bufferProperty.FrozenSize());
+
+        bufferProperty.ForEachFrozen(
+            [&inserter](BufferValueProperty& val, bool) {
+                inserter.insert([&val](DBStatementSL3& stmt, int i) {
+                    stmt.bind(i, val.id);
+                    stmt.bind(i + 1, val.name);
+                    stmt.bind(i + 2, (int64_t)val.type);
+                    stmt.bind(i + 3, val.coll_id);
+                });
             });
 
-        const std::string prop_str = std::move(prop_sql).str();
-
-        conn->execute(prop_str, {});
-
-        bufferProperty.Reset();
+        bufferProperty.ReleaseFrozen();
     }
 
     void BufferDataSQ3::pushIndependentObjects() {
         NLDB_PROFILE_FUNCTION();
 
-        auto& tables = tables::getPropertyTypesTable();
-
         // first insert the objects that does not depend on other
         // objects because values depends on them
-        std::stringstream indep_sql;
-        indep_sql << utils::paramsbind::parseSQL(
-            "insert into @table (id, prop_id) values ",
-            {{"@table", tables[PropertyType::OBJECT]}}, false);
-
-        /**
-         ** TODO: check if the query is longer that the DB supports
-         **/
-
-        bufferIndependentObject.ForEach(
-            [&indep_sql](BufferValueIndependentObject& val, bool isLast) {
-                indep_sql << "(" << val.id << ", " << val.prop_id << ")"
-                          << (isLast ? ";" : ",");
+        RowsInserter inserter(sq3Conn, "insert into object (id, prop_id)", 2,
+                              bufferIndependentObject.FrozenSize());
+
+        bufferIndependentObject.ForEachFrozen(
+            [&inserter](BufferValueIndependentObject& val, bool) {
+                inserter.insert([&val](DBStatementSL3& stmt, int i) {
+                    stmt.bind(i, val.id);
+                    stmt.bind(i + 1, val.prop_id);
+                });
             });
 
-        const std::string indep_str = std::move(indep_sql).str();
-
-        conn->execute(indep_str, {});
-
-        bufferIndependentObject.Reset();
+        bufferIndependentObject.ReleaseFrozen();
     }
 
     void BufferDataSQ3::pushDependentObjects() {
         NLDB_PROFILE_FUNCTION();
 
-        auto& tables = tables::getPropertyTypesTable();
-
         // now that we have inserted the object that does not depend on other
         // objects, we can insert the objects that do depend on other objects.
         // Else the foreign key wouldn't exist.
-
-        std::stringstream dependent_sql;
-        dependent_sql << utils::paramsbind::parseSQL(
-            "insert into @table (id, prop_id, obj_id) values ",
-            {{"@table", tables[PropertyType::OBJECT]}}, false);
-
-        /**
-         ** TODO: check if the query is longer that the DB supports
-         **/
-
-        bufferDependentObject.ForEach(
-            [&dependent_sql](BufferValueDependentObject& val, bool isLast) {
-                dependent_sql << "(" << val.id << "," << val.prop_id << ","
-                              << val.obj_id << ")" << (isLast ? ";" : ",");
+        RowsInserter inserter(sq3Conn,
+                              "insert into object (id, prop_id, obj_id)", 3,
+                              bufferDependentObject.FrozenSize());
+
+        bufferDependentObject.ForEachFrozen(
+            [&inserter](BufferValueDependentObject& val, bool) {
+                inserter.insert([&val](DBStatementSL3& stmt, int i) {
+                    stmt.bind(i, val.id);
+                    stmt.bind(i + 1, val.prop_id);
+                    stmt.bind(i + 2, val.obj_id);
+                });
             });
 
-        const std::string dependent_s = std::move(dependent_sql).str();
-
-        conn->execute(dependent_s, {});
-
-        bufferDependentObject.Reset();
+        bufferDependentObject.ReleaseFrozen();
     }
 
     void BufferDataSQ3::pushStringLikeValues() {
@@ -143,46 +220,77 @@ namespace nldb {
 
         auto& tables = tables::getPropertyTypesTable();
 
-        std::map<PropertyType, std::stringstream> queries;
+        // each type has its own table, so group the values by it
+        std::unordered_map<PropertyType, std::vector<BufferValueStringLike*>>
+            values;
 
-        bufferStringLike.ForEach(
-            [&queries, &tables](BufferValueStringLike& val, bool) {
-                if (!queries.contains(val.type)) {
-                    queries[val.type] = {};
-                    queries[val.type] << utils::paramsbind::parseSQL(
-                        "insert into @table (prop_id, obj_id, value) values ",
-                        {{"@table", tables[val.type]}}, false);
-                }
+        bufferStringLike.ForEachFrozen(
+            [&values](BufferValueStringLike& val, bool) {
+                values[val.type].push_back(&val);
+            });
+
+        for (auto& [type, rows] : values) {
+            RowsInserter inserter(
+                sq3Conn,
+                "insert into " + tables[type] + " (prop_id, obj_id, value)", 3,
+                rows.size(), upsertValue);
+
+            for (auto val : rows) {
+                inserter.insert([val](DBStatementSL3& stmt, int i) {
+                    stmt.bind(i, val->propID);
+                    stmt.bind(i + 1, val->objID);
+                    stmt.bind(i + 2, val->value);
+                });
+            }
+        }
+
+        bufferStringLike.ReleaseFrozen();
+    }
+
+    void BufferDataSQ3::pushIntegerValues() {
+        NLDB_PROFILE_FUNCTION();
 
-                /**
-                 * TODO: check if the query is longer that the DB supports
-                 */
+        RowsInserter inserter(
+            sq3Conn, "insert into value_int (prop_id, obj_id, value)", 3,
+            bufferInteger.FrozenSize(), upsertValue);
 
-                queries[val.type]
-                    << "(" << val.propID << "," << val.objID << ","
-                    << utils::paramsbind::encloseQuotesConst(val.value) << "),";
+        bufferInteger.ForEachFrozen([&inserter](BufferValueInteger& val, bool) {
+            inserter.insert([&val](DBStatementSL3& stmt, int i) {
+                stmt.bind(i, val.propID);
+                stmt.bind(i + 1, val.objID);
+                stmt.bind(i + 2, val.value);
             });
+        });
 
-        std::stringstream sql;
+        bufferInteger.ReleaseFrozen();
+    }
 
-        for (auto& [p, subq] : queries) {
-            sql << subq.rdbuf();
-            // change last , for a ;
-            sql.seekp(sql.tellp() - 1l);
-            sql << ";";
-        }
+    void BufferDataSQ3::pushDoubleValues() {
+        NLDB_PROFILE_FUNCTION();
 
-        const std::string depVal_s = std::move(sql).str();
+        RowsInserter inserter(
+            sq3Conn, "insert into value_double (prop_id, obj_id, value)", 3,
+            bufferDouble.FrozenSize(), upsertValue);
 
-        conn->execute(depVal_s, {});
+        bufferDouble.ForEachFrozen([&inserter](BufferValueDouble& val, bool) {
+            inserter.insert([&val](DBStatementSL3& stmt, int i) {
+                stmt.bind(i, val.propID);
+                stmt.bind(i + 1, val.objID);
+                stmt.bind(i + 2, val.value);
+            });
+        });
 
-        bufferStringLike.Reset();
+        bufferDouble.ReleaseFrozen();
     }
 
     BufferDataSQ3::~BufferDataSQ3() {
+        // it pushes the data using this object
+        this->stopBackgroundFlusher();
+
         // if we didn't loose the connection
         if (this->conn) {
             this->pushPendingData();
+            this->commitPendingData();
         } else {
             NLDB_WARN(
                 "Database was destroyed before we could push pending data! "
@@ -191,4 +299,4 @@ namespace nldb {
         }
     }
 
-}  // namespace nldb
\ No newline at end of file
+}  // namespace nldb
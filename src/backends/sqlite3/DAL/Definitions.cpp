@@ -1,6 +1,8 @@
 #include <unordered_map>
 
 #include "nldb/Property/Property.hpp"
+#include "nldb/Utils/ParamsBindHelpers.hpp"
+#include "nldb/backends/sqlite3/DAL/Definitions.hpp"
 
 namespace nldb::definitions {
     namespace tables {
@@ -15,5 +17,16 @@ namespace nldb::definitions {
 
             return propertyTypeTable;
         }
+
+        TableQuery::TableQuery(const std::string& sql) {
+            for (auto& [type, table] : getPropertyTypesTable()) {
+                queries[type] = utils::paramsbind::parseSQL(
+                    sql, {{"@table", table}}, false);
+            }
+        }
+
+        const std::string& TableQuery::operator[](PropertyType type) const {
+            return queries.at(type);
+        }
     }  // namespace tables
 }  // namespace nldb::definitions
\ No newline at end of file
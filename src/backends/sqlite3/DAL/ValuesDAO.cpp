@@ -3,13 +3,17 @@
 #include <map>
 #include <optional>
 #include <sstream>
+#include <stdexcept>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
 #include "magic_enum.hpp"
+#include "nldb/Exceptions.hpp"
 #include "nldb/LOG/log.hpp"
 #include "nldb/Property/Property.hpp"
-#include "nldb/Utils/ParamsBindHelpers.hpp"
 #include "nldb/backends/sqlite3/DAL/Definitions.hpp"
+#include "nldb/backends/sqlite3/DB/DBInitializer.hpp"
 
 namespace nldb {
     using namespace definitions;
@@ -17,38 +21,45 @@ namespace nldb {
     ValuesDAO::ValuesDAO(IDB* pConnection) : conn(pConnection) {}
 
     void ValuesDAO::addStringLike(snowflake propID, snowflake objID,
-                                  PropertyType type, std::string value) {
-        const std::string sql =
+                                  PropertyType type, std::string_view value) {
+        static const tables::TableQuery sql(
             "insert into @table (obj_id, prop_id, value) values (@obj_id, "
-            "@prop_id, @value);";
+            "@prop_id, @value);");
+
+        conn->execute(sql[type], {{"@obj_id", objID},
+                                  {"@prop_id", propID},
+                                  {"@value", value}});
+    }
+
+    void ValuesDAO::addInteger(snowflake propID, snowflake objID,
+                               int64_t value) {
+        conn->execute(
+            "insert into value_int (obj_id, prop_id, value) values (@obj_id, "
+            "@prop_id, @value);",
+            {{"@obj_id", objID}, {"@prop_id", propID}, {"@value", value}});
+    }
 
-        conn->execute(sql, {{"@table", tables::getPropertyTypesTable()[type]},
-                            {"@obj_id", objID},
-                            {"@prop_id", propID},
-                            {"@value", value}});
+    void ValuesDAO::addDouble(snowflake propID, snowflake objID, double value) {
+        conn->execute(
+            "insert into value_double (obj_id, prop_id, value) values "
+            "(@obj_id, @prop_id, @value);",
+            {{"@obj_id", objID}, {"@prop_id", propID}, {"@value", value}});
     }
 
     snowflake ValuesDAO::addObject(snowflake propID,
                                    std::optional<snowflake> objID) {
         if (objID.has_value()) {
             const std::string sql =
-                "insert into @table (prop_id, obj_id) "
+                "insert into object (prop_id, obj_id) "
                 "values (@prop_id, @obj_id);";
 
-            conn->execute(
-                sql, {{"@table",
-                       tables::getPropertyTypesTable()[PropertyType::OBJECT]},
-                      {"@prop_id", propID},
-                      {"@obj_id", objID.value()}});
+            conn->execute(sql,
+                          {{"@prop_id", propID}, {"@obj_id", objID.value()}});
         } else {
             const std::string sql =
-                "insert into @table (prop_id) "
-                "values (@prop_id);";
+                "insert into object (prop_id) values (@prop_id);";
 
-            conn->execute(
-                sql, {{"@table",
-                       tables::getPropertyTypesTable()[PropertyType::OBJECT]},
-                      {"@prop_id", propID}});
+            conn->execute(sql, {{"@prop_id", propID}});
         }
 
         return conn->getLastInsertedRowId();
@@ -58,56 +69,100 @@ namespace nldb {
                                          std::optional<snowflake> objID) {
         if (objID.has_value()) {
             const std::string sql =
-                "insert into @table (id, prop_id, obj_id) "
+                "insert into object (id, prop_id, obj_id) "
                 "values (@id, @prop_id, @obj_id);";
 
-            conn->execute(
-                sql, {{"@table",
-                       tables::getPropertyTypesTable()[PropertyType::OBJECT]},
-                      {"@prop_id", propID},
-                      {"@obj_id", objID.value()},
-                      {"@id", id}});
+            conn->execute(sql, {{"@prop_id", propID},
+                                {"@obj_id", objID.value()},
+                                {"@id", id}});
         } else {
             const std::string sql =
-                "insert into @table (id, prop_id) values (@id, @prop_id);";
+                "insert into object (id, prop_id) values (@id, @prop_id);";
 
-            conn->execute(
-                sql, {{"@table",
-                       tables::getPropertyTypesTable()[PropertyType::OBJECT]},
-                      {"@prop_id", propID},
-                      {"@id", id}});
+            conn->execute(sql, {{"@prop_id", propID}, {"@id", id}});
         }
 
         return id;
     }
 
     void ValuesDAO::updateStringLike(snowflake propID, snowflake objID,
-                                     PropertyType type, std::string value) {
-        const std::string sql =
+                                     PropertyType type,
+                                     std::string_view value) {
+        static const tables::TableQuery sql(
             "update @table set value = @prop_value where "
-            "obj_id = @obj_id and prop_id = @prop_id;";
+            "obj_id = @obj_id and prop_id = @prop_id;");
+
+        conn->execute(sql[type], {{"@prop_value", value},
+                                  {"@obj_id", objID},
+                                  {"@prop_id", propID}});
+    }
+
+    void ValuesDAO::upsertStringLike(snowflake propID, snowflake objID,
+                                     PropertyType type,
+                                     std::string_view value) {
+        static const tables::TableQuery sql(
+            "insert into @table (obj_id, prop_id, value) values (@obj_id, "
+            "@prop_id, @value) on conflict (obj_id, prop_id) do update set "
+            "value = excluded.value;");
+
+        conn->execute(sql[type], {{"@obj_id", objID},
+                                  {"@prop_id", propID},
+                                  {"@value", value}});
+    }
+
+    void ValuesDAO::upsertInteger(snowflake propID, snowflake objID,
+                                  int64_t value) {
+        conn->execute(
+            "insert into value_int (obj_id, prop_id, value) values (@obj_id, "
+            "@prop_id, @value) on conflict (obj_id, prop_id) do update set "
+            "value = excluded.value;",
+            {{"@obj_id", objID}, {"@prop_id", propID}, {"@value", value}});
+    }
+
+    void ValuesDAO::upsertDouble(snowflake propID, snowflake objID,
+                                 double value) {
+        conn->execute(
+            "insert into value_double (obj_id, prop_id, value) values "
+            "(@obj_id, @prop_id, @value) on conflict (obj_id, prop_id) do "
+            "update set value = excluded.value;",
+            {{"@obj_id", objID}, {"@prop_id", propID}, {"@value", value}});
+    }
 
+    void ValuesDAO::applyIntegerOperator(snowflake propID, snowflake objID,
+                                         UpdateOperator op, int64_t value) {
         conn->execute(
-            utils::paramsbind::parseSQL(
-                sql, {{"@table", tables::getPropertyTypesTable()[type]},
-                      {"@prop_value", value},
-                      {"@obj_id", objID},
-                      {"@prop_id", propID}}),
-            {});
+            "insert into value_int (obj_id, prop_id, value) values (@obj_id, "
+            "@prop_id, @value) on conflict (obj_id, prop_id) do update set "
+            "value = " +
+                getOperatorExpression(op) + " where " +
+                getIntegerOperatorGuard(op) + ";",
+            {{"@obj_id", objID}, {"@prop_id", propID}, {"@value", value}});
+
+        // the stored value is left as it was
+        if (conn->getChangesCount().value_or(0) == 0) {
+            throw InvalidUpdate("the integer overflows, property " +
+                                std::to_string(propID));
+        }
+    }
+
+    void ValuesDAO::applyDoubleOperator(snowflake propID, snowflake objID,
+                                        UpdateOperator op, double value) {
+        conn->execute(
+            "insert into value_double (obj_id, prop_id, value) values "
+            "(@obj_id, @prop_id, @value) on conflict (obj_id, prop_id) do "
+            "update set value = " +
+                getOperatorExpression(op) + ";",
+            {{"@obj_id", objID}, {"@prop_id", propID}, {"@value", value}});
     }
 
     bool ValuesDAO::exists(snowflake propID, snowflake objID,
                            PropertyType type) {
-        const std::string sql =
+        static const tables::TableQuery sql(
             "select id from @table where prop_id = @prop_id and obj_id = "
-            "@obj_id;";
+            "@obj_id;");
 
         auto result = conn->executeAndGetFirstInt(
-            utils::paramsbind::parseSQL(
-                sql, {{"@table", tables::getPropertyTypesTable()[type]},
-                      {"@obj_id", objID},
-                      {"@prop_id", propID}}),
-            {});
+            sql[type], {{"@obj_id", objID}, {"@prop_id", propID}});
 
         return result.has_value();
     }
@@ -115,45 +170,119 @@ namespace nldb {
     std::optional<snowflake> ValuesDAO::findObjectId(snowflake propID,
                                                      snowflake objID) {
         const std::string sql =
-            "select id from @table where prop_id = @prop_id and obj_id = "
+            "select id from object where prop_id = @prop_id and obj_id = "
             "@obj_id;";
 
         return conn->executeAndGetFirstInt(
-            utils::paramsbind::parseSQL(
-                sql, {{"@table",
-                       tables::getPropertyTypesTable()[PropertyType::OBJECT]},
-                      {"@prop_id", propID},
-                      {"@obj_id", objID}}),
-            {});
+            sql, {{"@prop_id", propID}, {"@obj_id", objID}});
     }
 
     void ValuesDAO::removeObject(snowflake objID) {
-        std::stringstream sql;
+        // the object and its sub-objects, at any depth
+        static const tables::TableQuery sql(
+            "with recursive tree(id) as (select @obj_id union all select "
+            "o.id from object as o join tree as t on o.obj_id = t.id) "
+            "delete from @table where obj_id in (select id from tree);");
 
-        auto& tables = tables::getPropertyTypesTable();
+        // remove all of it or nothing
+        const bool ownTransaction = !conn->isInTransaction();
+        if (ownTransaction) conn->begin();
 
-        for (auto& [type, tab_name] : tables) {
-            sql << "delete from " << tab_name << " where obj_id = " << objID
-                << ";";
-        }
+        try {
+            // BOOLEAN shares the table with INTEGER, the objects go last since
+            // they are the tree
+            for (auto type : {PropertyType::STRING, PropertyType::INTEGER,
+                              PropertyType::DOUBLE, PropertyType::ARRAY,
+                              PropertyType::OBJECT}) {
+                conn->execute(sql[type], {{"@obj_id", objID}});
+            }
 
-        sql << "delete from " << tables[PropertyType::OBJECT]
-            << " where id = " << objID << ";";
+            conn->execute("delete from object where id = @obj_id;",
+                          {{"@obj_id", objID}});
+        } catch (...) {
+            if (ownTransaction) conn->rollback();
+            throw;
+        }
 
-        conn->execute(sql.str(), {});
+        if (ownTransaction) conn->commit();
     }
 
     bool ValuesDAO::existsObject(snowflake objID) {
-        const std::string sql = "select id from @table where id = @obj_id;";
-
-        return conn
-            ->executeAndGetFirstInt(
-                utils::paramsbind::parseSQL(
-                    sql,
-                    {{"@table",
-                      tables::getPropertyTypesTable()[PropertyType::OBJECT]},
-                     {"@obj_id", objID}}),
-                {})
+        const std::string sql = "select id from object where id = @obj_id;";
+
+        return conn->executeAndGetFirstInt(sql, {{"@obj_id", objID}})
             .has_value();
     }
-}  // namespace nldb
\ No newline at end of file
+
+    /**
+     * @brief All the values of a type share the same table, so the index is a
+     * partial one that only covers the rows of the property. Its name is
+     * derived from the property id, which makes it easy to find it again.
+     */
+    constexpr std::string_view index_name_prefix = "idx_prop_";
+
+    inline std::string getIndexName(snowflake propID) {
+        return std::string(index_name_prefix) + std::to_string(propID);
+    }
+
+    void ValuesDAO::createIndex(snowflake propID, PropertyType type) {
+        if (type == PropertyType::OBJECT || type == PropertyType::ID) {
+            throw std::runtime_error(
+                "Only properties with a value can be indexed, index the "
+                "properties of the object instead");
+        }
+
+        // sqlite doesn't allow parameters in the where of a partial index
+        std::stringstream sql;
+        sql << "create index if not exists " << getIndexName(propID) << " on "
+            << tables::getPropertyTypesTable()[type]
+            << " (value, obj_id) where prop_id = " << propID << ";";
+
+        conn->execute(sql.str(), {});
+    }
+
+    void ValuesDAO::dropIndex(snowflake propID, PropertyType) {
+        conn->execute("drop index if exists " + getIndexName(propID) + ";",
+                      {});
+    }
+
+    std::vector<snowflake> ValuesDAO::findIndexedProperties() {
+        auto reader = conn->executeReader(
+            "select name from sqlite_master where type = 'index' and "
+            "substr(name, 1, @length) = @prefix;",
+            {{"@length", (int)index_name_prefix.size()},
+             {"@prefix", index_name_prefix}});
+
+        std::vector<snowflake> properties;
+
+        std::shared_ptr<IDBRowReader> row;
+        while (reader->readRow(row)) {
+            const std::string name = row->readString(0);
+
+            try {
+                properties.push_back(
+                    std::stoll(name.substr(index_name_prefix.size())));
+            } catch (const std::logic_error&) {
+                NLDB_WARN("Ignoring index with an unexpected name '{}'", name);
+            }
+        }
+
+        return properties;
+    }
+
+    void ValuesDAO::suspendIndex(snowflake propID) {
+        const std::string name = getIndexName(propID);
+
+        // the sql that created it is kept before dropping it
+        conn->execute(
+            "insert or replace into suspended_index (name, sql) select name, "
+            "sql from sqlite_master where type = 'index' and name = @name;",
+            {{"@name", name}});
+
+        conn->execute("drop index if exists " + name + ";", {});
+    }
+
+    void ValuesDAO::restoreIndexes() {
+        DBInitializer::restoreSuspendedIndexes(conn);
+    }
+}  // namespace nldb
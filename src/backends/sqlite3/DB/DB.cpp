@@ -1,5 +1,6 @@
 #include "nldb/backends/sqlite3/DB/DB.hpp"
 
+#include <cctype>
 #include <filesystem>
 #include <memory>
 #include <optional>
@@ -7,7 +8,6 @@
 
 #include "nldb/DB/IDBQueryReader.hpp"
 #include "nldb/LOG/log.hpp"
-#include "nldb/Utils/ParamsBindHelpers.hpp"
 #include "nldb/backends/sqlite3/DB/DBInitializer.hpp"
 #include "nldb/typedef.hpp"
 
@@ -22,9 +22,13 @@
 
 namespace nldb {
 
-    DBSL3::DBSL3() : page_cache_ptr(nullptr) {}
+    DBSL3::DBSL3()
+        : page_cache_ptr(nullptr), statements(config.statement_cache_size) {}
 
-    DBSL3::DBSL3(const DBConfig pCfg) : config(pCfg), page_cache_ptr(nullptr) {
+    DBSL3::DBSL3(const DBConfig pCfg)
+        : config(pCfg),
+          page_cache_ptr(nullptr),
+          statements(pCfg.statement_cache_size) {
         // configure page cache size
         if (pCfg.page_cache_N != -1 && pCfg.page_size != -1) {
             this->page_cache_ptr =
@@ -76,6 +80,10 @@ namespace nldb {
                   peakPageSize / 1024.0);
 
         NLDB_INFO("MALLOC_SIZE: peak={} KB", peakMalloc / 1024.0);
+
+        auto stats = statements.getStats();
+        NLDB_INFO("STATEMENT_CACHE: hits={} | misses={} | cached={}",
+                  stats.hits, stats.misses, stats.size);
         NLDB_INFO("======================================================");
     }
 
@@ -91,30 +99,78 @@ namespace nldb {
             return false;
         }
 
+        // pragmas can't have bound parameters
         this->execute(
             "PRAGMA journal_mode = WAL; PRAGMA synchronous = NORMAL; PRAGMA "
-            "page_size = @page_size",
-            {{"@page_size", config.page_size}});
+            "page_size = " +
+                std::to_string(config.page_size) + ";",
+            {});
 
         if (!fileExists) {
             DBInitializer::createTablesAndFKeys(this);
         }
 
+        DBInitializer::migrate(this);
+        DBInitializer::restoreSuspendedIndexes(this);
+
         return true;
     }
 
     bool DBSL3::close() {
         if (this->db != nullptr) {
+            // cached statements would keep the connection open
+            statements.clear();
+
             int rc = sqlite3_close(this->db);
 
             if (rc != SQLITE_OK) {
                 return false;
             }
+
+            this->db = nullptr;
         }
 
         return true;
     }
 
+    /**
+     * @brief Binds the parameters by their name.
+     */
+    void bindParameters(sqlite3_stmt* stmt, const Paramsbind& params) {
+        for (const auto& it : params) {
+            if (it.first.empty()) continue;
+
+            if (!it.first.starts_with("@") && !it.first.starts_with("$") &&
+                !it.first.starts_with("?") && !it.first.starts_with(":")) {
+                NLDB_WARN("The parameter '{}' doesn't start with @,$,: or ?",
+                          it.first.c_str());
+            }
+
+            int idx = sqlite3_bind_parameter_index(stmt, it.first.c_str());
+            if (std::holds_alternative<int>(it.second)) {
+                sqlite3_bind_int(stmt, idx, std::get<int>(it.second));
+            } else if (std::holds_alternative<double>(it.second)) {
+                sqlite3_bind_double(stmt, idx, std::get<double>(it.second));
+            } else if (std::holds_alternative<std::string>(it.second)) {
+                const auto& str = std::get<std::string>(it.second);
+                sqlite3_bind_text(stmt, idx, str.data(), str.size(),
+                                  SQLITE_TRANSIENT);
+                // SQLITE_TRANSIENT = copy, because params 99% of the time
+                // is a r-value and it would be an UB to use SQLITE_STATIC
+            } else if (std::holds_alternative<std::string_view>(it.second)) {
+                const auto str = std::get<std::string_view>(it.second);
+                sqlite3_bind_text(stmt, idx, str.data(), str.size(),
+                                  SQLITE_TRANSIENT);
+            } else if (std::holds_alternative<snowflake>(it.second)) {
+                sqlite3_bind_int64(stmt, idx, std::get<snowflake>(it.second));
+            } else {
+                // variant protects against this but anyway... in case we
+                // change it
+                throw std::runtime_error("Type not supported");
+            }
+        }
+    }
+
     std::unique_ptr<IDBQueryReader> DBSL3::executeReader(
         const std::string& query, const Paramsbind& params) {
 #ifdef NLDB_DEBUG_QUERY
@@ -126,53 +182,33 @@ namespace nldb {
             throw std::runtime_error("Empty query");
         }
 
-        // prepare sql
-        sqlite3_stmt* stmt;
-        int rc = sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, 0);
-
-        if (rc == SQLITE_OK) {
-            // bind params
-            for (const auto& it : params) {
-                if (it.first.empty()) continue;
-
-                if (!it.first.starts_with("@") && !it.first.starts_with("$") &&
-                    !it.first.starts_with("?") && !it.first.starts_with(":")) {
-                    NLDB_WARN(
-                        "The parameter '{}' doesn't start with @,$,: or ?",
-                        it.first.c_str());
-                }
-
-                int idx = sqlite3_bind_parameter_index(stmt, it.first.c_str());
-                if (std::holds_alternative<int>(it.second)) {
-                    sqlite3_bind_int(stmt, idx, std::get<int>(it.second));
-                } else if (std::holds_alternative<double>(it.second)) {
-                    sqlite3_bind_double(stmt, idx, std::get<double>(it.second));
-                } else if (std::holds_alternative<std::string>(it.second)) {
-                    sqlite3_bind_text(stmt, idx,
-                                      std::get<std::string>(it.second).c_str(),
-                                      -1, SQLITE_TRANSIENT);
-                    // SQLITE_TRANSIENT = copy, because params 99% of the time
-                    // is a r-value and it would be an UB to use SQLITE_STATIC
-                } else if (std::holds_alternative<snowflake>(it.second)) {
-                    sqlite3_bind_int64(stmt, idx,
-                                       std::get<snowflake>(it.second));
-                } else {
-                    // variant protects against this but anyway... in case we
-                    // change it
-                    throw std::runtime_error("Type not supported");
-                }
-            }
+        // prepare sql, unless we already did it
+        sqlite3_stmt* stmt = statements.acquire(query);
 
-            // we are done, now the user can read the results
-            return std::make_unique<DBQueryReaderSL3>(this, stmt);
-        } else {
-            this->throwLastError();
-            return nullptr;
+        if (stmt == nullptr) {
+            int rc = sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, 0);
+
+            if (rc != SQLITE_OK) {
+                this->throwLastError();
+                return nullptr;
+            }
         }
+
+        // the reader owns the statement from now on, even if binding fails
+        auto reader =
+            std::make_unique<DBQueryReaderSL3>(this, stmt, &statements, query);
+
+        bindParameters(stmt, params);
+
+        // we are done, now the user can read the results
+        return reader;
     }
 
     void DBSL3::begin() {
-        SQL3_EXEC_ERR_HNDL(db, "BEGIN TRANSACTION;",
+        // Take the write lock right away, all the transactions we start are
+        // meant to write. A deferred one would fail with SQLITE_BUSY if
+        // another connection writes before it gets upgraded.
+        SQL3_EXEC_ERR_HNDL(db, "BEGIN IMMEDIATE TRANSACTION;",
                            "Couldn't start the transaction");
     }
 
@@ -186,29 +222,92 @@ namespace nldb {
                            "Couldn't rollback the transaction");
     }
 
+    /**
+     * @brief Steps a statement until it's done, ignoring the rows it returns.
+     *
+     * @return int SQLITE_DONE or the error code
+     */
+    int stepUntilDone(sqlite3_stmt* stmt) {
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        }
+
+        return rc;
+    }
+
+    inline bool isBlank(const char* str) {
+        while (*str != '\0' && std::isspace(*str)) str++;
+        return *str == '\0';
+    }
+
+    bool DBSL3::isInTransaction() {
+        return db != nullptr && sqlite3_get_autocommit(db) == 0;
+    }
+
     void DBSL3::execute(const std::string& query, const Paramsbind& params) {
-        /**
-         * https://www.sqlite.org/lang_transaction.html#deferred_immediate_and_exclusive_transactions
-         * To do it in one step use sqlite3_finalize after prepare or simply use
-         * sqlite3_exec.
-         */
-        std::string sql = utils::paramsbind::parseSQL(query, params);
 #ifdef NLDB_DEBUG_QUERY
-        NLDB_TRACE("Executing: {}", sql);
+        NLDB_TRACE("Executing: {}", query);
 #endif
-        char* err = 0;
-        int rc = sqlite3_exec(db, sql.c_str(), 0, 0, &err);
 
-        if (rc != SQLITE_OK) {
-            if (err) {
-                NLDB_ERROR("Could not execute query, error: {}, with query: {}",
-                           err, sql);
+        // binds and runs the statement, on error returns the message
+        auto run = [this, &params](sqlite3_stmt* stmt) {
+            std::optional<std::string> error;
+
+            try {
+                bindParameters(stmt, params);
+            } catch (const std::exception& e) {
+                return std::optional<std::string>(e.what());
+            }
+
+            if (stepUntilDone(stmt) != SQLITE_DONE) {
+                error = sqlite3_errmsg(db);
+            }
+
+            return error;
+        };
+
+        auto onError = [&query](const std::string& err) {
+            NLDB_ERROR("Could not execute query, error: {}, with query: {}",
+                       err, query);
+            throw std::runtime_error(err);
+        };
+
+        // single statements are prepared only once and then reused
+        if (sqlite3_stmt* stmt = statements.acquire(query)) {
+            auto error = run(stmt);
+            statements.release(query, stmt);
+
+            if (error) onError(error.value());
+            return;
+        }
+
+        // else prepare and run each one of the statements in the query
+        const char* next = query.c_str();
+        while (!isBlank(next)) {
+            sqlite3_stmt* stmt = nullptr;
+            const char* tail = nullptr;
+
+            if (sqlite3_prepare_v2(db, next, -1, &stmt, &tail) != SQLITE_OK) {
+                onError(sqlite3_errmsg(db));
+            }
+
+            // comments or an empty statement
+            if (stmt == nullptr) {
+                next = tail;
+                continue;
+            }
+
+            auto error = run(stmt);
+
+            if (next == query.c_str() && isBlank(tail)) {
+                statements.release(query, stmt);
             } else {
-                NLDB_ERROR("Could not execute query: {}", sql);
+                sqlite3_finalize(stmt);
             }
 
-            sqlite3_free(err);
-            this->throwLastError();
+            if (error) onError(error.value());
+
+            next = tail;
         }
     }
 
@@ -235,8 +334,33 @@ namespace nldb {
         throw std::runtime_error(sqlite3_errmsg(this->db));
     }
 
+    DBStatementSL3 DBSL3::prepare(const std::string& query) {
+#ifdef NLDB_DEBUG_QUERY
+        NLDB_TRACE("Preparing: {}", query);
+#endif
+
+        sqlite3_stmt* stmt = statements.acquire(query);
+
+        if (stmt == nullptr &&
+            sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, 0) != SQLITE_OK) {
+            NLDB_ERROR("Could not prepare query, error: {}, with query: {}",
+                       sqlite3_errmsg(db), query);
+            this->throwLastError();
+        }
+
+        return DBStatementSL3(this, stmt, &statements, query);
+    }
+
+    int DBSL3::getMaxBoundParameters() {
+        return sqlite3_limit(db, SQLITE_LIMIT_VARIABLE_NUMBER, -1);
+    }
+
+    StatementCacheStats DBSL3::getStatementCacheStats() {
+        return statements.getStats();
+    }
+
     DBSL3::~DBSL3() {
-        sqlite3_close(this->db);
+        this->close();
 
         if (page_cache_ptr != nullptr) {
             free(page_cache_ptr);
@@ -1,5 +1,11 @@
 #include "nldb/backends/sqlite3/DB/DBInitializer.hpp"
 
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "nldb/LOG/log.hpp"
 
 namespace nldb {
@@ -84,6 +90,79 @@ namespace nldb {
         db->execute(sql, {});
     }
 
+    /**
+     * @brief Indexes for the access paths of the engine itself: the joins of
+     * the values/sub-objects to their object, the lookups of a value by
+     * property and object and the removal of all the values of an object.
+     * The values are always searched with both ids or only by obj_id, so it
+     * goes first. The objects are also filtered only by prop_id to get the
+     * documents of a collection.
+     */
+    void createStructuralIndexes(IDB* db) {
+        const auto sql =
+            "CREATE INDEX IF NOT EXISTS `value_int_obj_prop` ON "
+            "`value_int` (obj_id, prop_id);"
+            "CREATE INDEX IF NOT EXISTS `value_double_obj_prop` ON "
+            "`value_double` (obj_id, prop_id);"
+            "CREATE INDEX IF NOT EXISTS `value_string_obj_prop` ON "
+            "`value_string` (obj_id, prop_id);"
+            "CREATE INDEX IF NOT EXISTS `value_array_obj_prop` ON "
+            "`value_array` (obj_id, prop_id);"
+            "CREATE INDEX IF NOT EXISTS `object_prop_obj` ON "
+            "`object` (prop_id, obj_id);"
+            "CREATE INDEX IF NOT EXISTS `object_obj` ON `object` (obj_id);";
+
+        db->execute(sql, {});
+    }
+
+    /**
+     * @brief Makes (obj_id, prop_id) unique on each value table, so a value
+     * can be inserted or replaced with a single upsert. It replaces the
+     * structural index with the same columns. If an object somehow got more
+     * than one value for a property, only the last one inserted is kept.
+     */
+    void createValueKeys(IDB* db) {
+        std::string sql;
+
+        for (const char* table :
+             {"value_int", "value_double", "value_string", "value_array"}) {
+            const std::string t = table;
+
+            sql += "DELETE FROM `" + t + "` WHERE id NOT IN (SELECT max(id) "
+                   "FROM `" + t + "` GROUP BY obj_id, prop_id);";
+            sql += "DROP INDEX IF EXISTS `" + t + "_obj_prop`;";
+            sql += "CREATE UNIQUE INDEX `" + t + "_obj_prop` ON `" + t +
+                   "` (obj_id, prop_id);";
+        }
+
+        db->execute(sql, {});
+    }
+
+    /**
+     * @brief Keeps the indexes dropped while loading documents, with the sql
+     * that created them, until they are created again.
+     */
+    void createSuspendedIndexTable(IDB* db) {
+        const auto sql =
+            "CREATE TABLE IF NOT EXISTS `suspended_index` ("
+            "`name` varchar(255) PRIMARY KEY,"
+            "`sql` TEXT NOT NULL"
+            ");";
+
+        db->execute(sql, {});
+    }
+
+    /**
+     * @brief Each migration upgrades the schema from the version equal to its
+     * index to the next one. Add new ones at the end, never modify them.
+     */
+    constexpr std::array<void (*)(IDB*), DBInitializer::schemaVersion>
+        migrations = {
+            createStructuralIndexes,    // 0 -> 1
+            createValueKeys,            // 1 -> 2
+            createSuspendedIndexTable,  // 2 -> 3
+    };
+
     void DBInitializer::createTablesAndFKeys(IDB* db) {
         db->begin();
         createCollectionTable(db);
@@ -92,4 +171,62 @@ namespace nldb {
         createValuesTable(db);
         db->commit();
     }
+
+    void DBInitializer::migrate(IDB* db) {
+        int version =
+            db->executeAndGetFirstInt("PRAGMA user_version;", {}).value_or(0);
+
+        if (version >= schemaVersion) return;
+
+        db->begin();
+
+        try {
+            for (; version < schemaVersion; version++) {
+                NLDB_INFO("Migrating database schema from version {} to {}",
+                          version, version + 1);
+                migrations[version](db);
+            }
+
+            db->execute(
+                "PRAGMA user_version = " + std::to_string(schemaVersion) + ";",
+                {});
+        } catch (const std::exception& e) {
+            NLDB_ERROR("Couldn't migrate the database schema: {}", e.what());
+            db->rollback();
+            throw;
+        }
+
+        db->commit();
+    }
+
+    void DBInitializer::restoreSuspendedIndexes(IDB* db) {
+        std::vector<std::pair<std::string, std::string>> suspended;
+
+        {
+            auto reader =
+                db->executeReader("select name, sql from suspended_index;", {});
+
+            std::shared_ptr<IDBRowReader> row;
+            while (reader->readRow(row)) {
+                suspended.emplace_back(row->readString(0), row->readString(1));
+            }
+        }
+
+        for (auto& [name, sql] : suspended) {
+            NLDB_INFO("Restoring the suspended index '{}'", name);
+
+            const bool exists =
+                db->executeAndGetFirstInt(
+                      "select count(*) from sqlite_master where type = "
+                      "'index' and name = @name;",
+                      {{"@name", name}})
+                    .value_or(0) > 0;
+
+            // forget it only once it's created, so it's not lost in between
+            if (!exists) db->execute(sql, {});
+
+            db->execute("delete from suspended_index where name = @name;",
+                        {{"@name", name}});
+        }
+    }
 }  // namespace nldb
\ No newline at end of file
@@ -53,8 +53,16 @@ namespace nldb {
         }
     }
 
-    DBQueryReaderSL3::DBQueryReaderSL3(IDB* pDb, sqlite3_stmt* pStmt)
-        : db(pDb), stmt(pStmt) {}
+    DBQueryReaderSL3::DBQueryReaderSL3(IDB* pDb, sqlite3_stmt* pStmt,
+                                       StatementCache* pCache,
+                                       std::string pSql)
+        : db(pDb), stmt(pStmt), cache(pCache), sql(std::move(pSql)) {}
 
-    DBQueryReaderSL3::~DBQueryReaderSL3() { sqlite3_finalize(stmt); }
+    DBQueryReaderSL3::~DBQueryReaderSL3() {
+        if (cache) {
+            cache->release(std::move(sql), stmt);
+        } else {
+            sqlite3_finalize(stmt);
+        }
+    }
 }  // namespace nldb
\ No newline at end of file
@@ -0,0 +1,53 @@
+#include "nldb/backends/sqlite3/DB/DBStatement.hpp"
+
+#include <utility>
+
+namespace nldb {
+    DBStatementSL3::DBStatementSL3(IDB* pDb, sqlite3_stmt* pStmt,
+                                   StatementCache* pCache, std::string pSql)
+        : db(pDb), stmt(pStmt), cache(pCache), sql(std::move(pSql)) {}
+
+    DBStatementSL3::DBStatementSL3(DBStatementSL3&& other)
+        : db(other.db),
+          stmt(std::exchange(other.stmt, nullptr)),
+          cache(other.cache),
+          sql(std::move(other.sql)) {}
+
+    void DBStatementSL3::bind(int i, int64_t value) {
+        sqlite3_bind_int64(stmt, i, value);
+    }
+
+    void DBStatementSL3::bind(int i, double value) {
+        sqlite3_bind_double(stmt, i, value);
+    }
+
+    void DBStatementSL3::bind(int i, std::string_view value) {
+        sqlite3_bind_text(stmt, i, value.data(), value.size(),
+                          SQLITE_TRANSIENT);
+    }
+
+    void DBStatementSL3::bindNull(int i) { sqlite3_bind_null(stmt, i); }
+
+    void DBStatementSL3::execute() {
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        }
+
+        if (rc != SQLITE_DONE) {
+            sqlite3_reset(stmt);
+            db->throwLastError();
+        }
+
+        sqlite3_reset(stmt);
+    }
+
+    DBStatementSL3::~DBStatementSL3() {
+        if (stmt == nullptr) return;
+
+        if (cache) {
+            cache->release(std::move(sql), stmt);
+        } else {
+            sqlite3_finalize(stmt);
+        }
+    }
+}  // namespace nldb
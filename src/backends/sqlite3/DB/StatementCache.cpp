@@ -0,0 +1,69 @@
+#include "nldb/backends/sqlite3/DB/StatementCache.hpp"
+
+namespace nldb {
+    StatementCache::StatementCache(size_t pCapacity) : capacity(pCapacity) {}
+
+    sqlite3_stmt* StatementCache::acquire(const std::string& sql) {
+        std::lock_guard<std::mutex> lock(mtx);
+
+        auto it = index.find(sql);
+        if (it == index.end()) {
+            misses++;
+            return nullptr;
+        }
+
+        hits++;
+
+        sqlite3_stmt* stmt = it->second->second;
+        entries.erase(it->second);
+        index.erase(it);
+
+        return stmt;
+    }
+
+    void StatementCache::release(std::string sql, sqlite3_stmt* stmt) {
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+
+        std::lock_guard<std::mutex> lock(mtx);
+
+        // the cache is disabled, another reader already gave it back or it
+        // has no parameters, which means that its values are in the sql and
+        // it's unlikely to be seen again.
+        if (capacity == 0 || index.contains(sql) ||
+            sqlite3_bind_parameter_count(stmt) == 0) {
+            sqlite3_finalize(stmt);
+            return;
+        }
+
+        if (entries.size() >= capacity) {
+            auto& last = entries.back();
+            index.erase(last.first);
+            sqlite3_finalize(last.second);
+            entries.pop_back();
+        }
+
+        entries.emplace_front(std::move(sql), stmt);
+        index.emplace(entries.front().first, entries.begin());
+    }
+
+    void StatementCache::clear() {
+        std::lock_guard<std::mutex> lock(mtx);
+
+        for (auto& [sql, stmt] : entries) {
+            sqlite3_finalize(stmt);
+        }
+
+        index.clear();
+        entries.clear();
+    }
+
+    StatementCacheStats StatementCache::getStats() {
+        std::lock_guard<std::mutex> lock(mtx);
+
+        return StatementCacheStats {
+            .hits = hits, .misses = misses, .size = entries.size()};
+    }
+
+    StatementCache::~StatementCache() { clear(); }
+}  // namespace nldb
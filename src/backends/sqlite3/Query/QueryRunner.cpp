@@ -1,6 +1,7 @@
 #include "nldb/backends/sqlite3/Query/QueryRunner.hpp"
 
 #include <algorithm>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <map>
@@ -25,6 +26,8 @@
 #include "nldb/Property/SortedProperty.hpp"
 #include "nldb/Query/QueryContext.hpp"
 #include "nldb/Query/QueryRunner.hpp"
+#include "nldb/Query/Transaction.hpp"
+#include "nldb/Query/UpdateOperator.hpp"
 #include "nldb/Utils/Enums.hpp"
 #include "nldb/Utils/ParamsBindHelpers.hpp"
 #include "nldb/Utils/Variant.hpp"
@@ -453,13 +456,13 @@ namespace nldb {
     void addWhereClause(std::stringstream& sql, PropertyExpression const& expr,
                         QueryRunnerCtx& ctx);
 
+    // name of the parameter of the i-th constant of a where
+    std::string constantParameter(int i) { return "@c" + std::to_string(i); }
+
     void addWhereExpression(std::stringstream& sql,
                             PropertyExpressionOperand const& expr,
                             QueryRunnerCtx& ctx) {
-        auto cbConstVal = overloaded {
-            [&sql, &ctx](const Property& prop) {
-                sql << ctx.getContextualizedAlias(prop, ctx.getRootCollId());
-            },
+        auto cbLiteral = overloaded {
             [&sql](const std::string& str) { sql << encloseQuotesConst(str); },
             [&sql](int val) { sql << val; },
             [&sql](double val) { sql << val; },
@@ -467,6 +470,18 @@ namespace nldb {
             [&sql](long long val) { sql << val; },
             [&sql](const char* str) { sql << encloseQuotesConst(str); }};
 
+        auto cbConstVal = overloaded {
+            [&sql, &ctx](const Property& prop) {
+                sql << ctx.getContextualizedAlias(prop, ctx.getRootCollId());
+            },
+            [&sql, &ctx, &cbLiteral](const auto& val) {
+                if (ctx.bindConstants) {
+                    sql << constantParameter(ctx.boundConstants++);
+                } else {
+                    cbLiteral(val);
+                }
+            }};
+
         auto cbOperand = overloaded {
             [&cbConstVal](LogicConstValue const& prop) {
                 std::visit(cbConstVal, prop);
@@ -517,6 +532,52 @@ namespace nldb {
         }
     }
 
+    void bindWhereConstants(PropertyExpression const& expr,
+                            Paramsbind& params, int& bound);
+
+    /**
+     * @brief Binds the constants of the where to the parameters written for
+     * them, see QueryRunnerCtx::bindConstants. They are visited in the same
+     * order as addWhereExpression writes them.
+     */
+    void bindWhereConstants(PropertyExpressionOperand const& expr,
+                            Paramsbind& params, int& bound) {
+        auto bind = [&params, &bound](ParamsBindValue value) {
+            params.push_back({constantParameter(bound++), std::move(value)});
+        };
+
+        auto cbConstVal = overloaded {
+            [](const Property&) {},
+            [&bind](const std::string& str) { bind(str); },
+            [&bind](int val) { bind(val); },
+            [&bind](double val) { bind(val); },
+            [&bind](long val) { bind((snowflake)val); },
+            [&bind](long long val) { bind((snowflake)val); },
+            [&bind](const char* str) { bind(std::string(str)); }};
+
+        auto cbOperand = overloaded {
+            [&cbConstVal](LogicConstValue const& prop) {
+                std::visit(cbConstVal, prop);
+            },
+            [&params, &bound](box<struct PropertyExpression> const& agProp) {
+                bindWhereConstants(*agProp, params, bound);
+            },
+            [&params, &bound](PropertyExpressionOperand const& agProp) {
+                bindWhereConstants(agProp, params, bound);
+            }};
+
+        std::visit(cbOperand, expr);
+    }
+
+    void bindWhereConstants(PropertyExpression const& expr,
+                            Paramsbind& params, int& bound) {
+        bindWhereConstants(expr.left, params, bound);
+
+        if (expr.type != PropertyExpressionOperator::NOT) {
+            bindWhereConstants(expr.right, params, bound);
+        }
+    }
+
     /* ----------------- GROUP BY CLAUSE ---------------- */
     void addGroupByClause(std::stringstream& sql, std::vector<Property>& props,
                           QueryRunnerCtx& ctx) {
@@ -556,10 +617,20 @@ namespace nldb {
     }
 
     /* ------------------ LIMIT CLAUSE ------------------ */
-    void addPaginationClause(std::stringstream& sql,
-                             const QueryPagination& limit) {
-        sql << " limit " << limit.elementsPerPage << " offset "
-            << (limit.pageNumber - 1) * limit.elementsPerPage;
+    void addPaginationClause(std::stringstream& sql) {
+        sql << " limit @limit offset @offset";
+    }
+
+    void bindPagination(QueryPlannerContextSelect& data, Paramsbind& params) {
+        const auto& page = data.pagination_value.value();
+
+        // the pages start at the keyset instead of skipping rows
+        const int offset = data.keyset_value
+                               ? 0
+                               : (page.pageNumber - 1) * page.elementsPerPage;
+
+        params.push_back({"@limit", page.elementsPerPage});
+        params.push_back({"@offset", offset});
     }
 
     void selectAllOnEmpty(QueryPlannerContextSelect& data,
@@ -1066,20 +1137,21 @@ namespace nldb {
             out[renameTo(composed.getProperty(), rename)] = std::move(temp);
     }
 
-    json readQuery(std::stringstream& sql, nldb::IDB* connection,
-                   QueryPlannerContextSelect& data) {
+    long long readQuery(
+        SelectPlan& plan, const Paramsbind& params, nldb::IDB* connection,
+        const std::function<bool(json&, IDBRowReader&, int)>& onRow) {
         NLDB_PROFILE_FUNCTION();
         std::unique_ptr<nldb::IDBQueryReader> reader;
         std::shared_ptr<IDBRowReader> row;
 
         {
             NLDB_PROFILE_SCOPE("execute reader");
-            reader = connection->executeReader(sql.str(), {});
+            reader = connection->executeReader(plan.sql, params);
         }
 
-        json result = json::array();
-        auto begin = data.select_value.begin();
-        auto end = data.select_value.end();
+        long long documents = 0;
+        auto begin = plan.columns.begin();
+        auto end = plan.columns.end();
 
         while (true) {
             {
@@ -1090,22 +1162,23 @@ namespace nldb {
             NLDB_PROFILE_SCOPE("into json");
 
             json rowValue;
-            {
-                int i = 0;
-                for (auto it = begin; it != end; it++) {
-                    std::visit(
-                        [&row, &i, &rowValue, &data](auto& val) {
-                            read(val, row, i, rowValue, data.suppress_value,
-                                 data.renamed_value);
-                        },
-                        *it);
-                }
+            int i = 0;
+            for (auto it = begin; it != end; it++) {
+                std::visit(
+                    [&row, &i, &rowValue, &plan](auto& val) {
+                        read(val, row, i, rowValue, plan.suppressed,
+                             plan.renamed);
+                    },
+                    *it);
             }
 
-            if (!rowValue.is_null()) result.push_back(std::move(rowValue));
+            if (rowValue.is_null()) continue;
+
+            documents++;
+            if (!onRow(rowValue, *row, i)) break;
         }
 
-        return result;
+        return documents;
     }
 
     void printSelect(Property& p, int tab = 0) {
@@ -1143,14 +1216,382 @@ namespace nldb {
         std::cout << "\n";
     }
 
+    /* ------------------ KEYSET PAGINATION ----------------- */
+    // expression of a key of the documents and the order to read them by it
+    typedef std::pair<std::string, SortType> KeysetKey;
+
+    /**
+     * @brief The keys that give each document its place: the sort properties
+     * followed by the document id. To read the documents before a keyset
+     * they are read in the opposite order.
+     */
+    std::vector<KeysetKey> getKeyset(QueryPlannerContextSelect& data,
+                                     QueryRunnerCtx& ctx) {
+        const bool before = data.keyset_value->before;
+        auto order = [before](SortType type) {
+            if (!before) return type;
+            return type == SortType::ASC ? SortType::DESC : SortType::ASC;
+        };
+
+        std::vector<KeysetKey> keys;
+        for (auto& sorted : data.sortBy_value) {
+            keys.push_back(
+                {ctx.getContextualizedAlias(sorted.property,
+                                            ctx.getRootCollId()),
+                 order(sorted.type)});
+        }
+
+        keys.push_back({std::string(doc_alias) + ".id", order(SortType::ASC)});
+
+        return keys;
+    }
+
+    // name of the parameter of the i-th value of a keyset
+    std::string keysetParameter(size_t i) {
+        return "@k" + std::to_string(i);
+    }
+
+    /**
+     * @brief condition of the documents whose `key` follows `value`, in
+     * SQLite the nulls are the smallest values.
+     */
+    std::string followsKey(const KeysetKey& key, const json& value,
+                           const std::string& parameter) {
+        const auto& [expr, order] = key;
+
+        if (order == SortType::ASC) {
+            return value.is_null() ? expr + " IS NOT NULL"
+                                   : expr + " > " + parameter;
+        }
+
+        return value.is_null() ? "0"
+                               : "(" + expr + " < " + parameter + " OR " +
+                                     expr + " IS NULL)";
+    }
+
+    void addKeysetSelectClause(std::stringstream& sql,
+                               std::vector<KeysetKey>& keys) {
+        for (auto& key : keys) {
+            sql << ", " << key.first;
+        }
+    }
+
+    /**
+     * @brief Selects the documents that follow the keyset: those with a
+     * greater first key, or with the same first key and a greater second one,
+     * and so on.
+     */
+    void addKeysetWhereClause(std::stringstream& sql,
+                              std::vector<KeysetKey>& keys,
+                              const json& values) {
+        if (values.empty()) return;
+
+        if (values.size() != keys.size()) {
+            throw std::runtime_error(
+                "The page token doesn't match the sorted properties");
+        }
+
+        sql << " AND (";
+
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (i > 0) sql << " OR ";
+
+            sql << "(";
+            for (size_t j = 0; j < i; j++) {
+                sql << keys[j].first << " IS "
+                    << (values[j].is_null() ? "NULL" : keysetParameter(j))
+                    << " AND ";
+            }
+            sql << followsKey(keys[i], values[i], keysetParameter(i)) << ")";
+        }
+
+        sql << ")";
+    }
+
+    /**
+     * @brief Binds the values of the keyset that are not null, the null ones
+     * are written in the sql.
+     */
+    void bindKeyset(const json& values, Paramsbind& params) {
+        for (size_t i = 0; i < values.size(); i++) {
+            const json& value = values[i];
+
+            if (value.is_null()) continue;
+
+            if (value.is_boolean()) {
+                params.push_back(
+                    {keysetParameter(i), value.get<bool>() ? 1 : 0});
+            } else if (value.is_number_integer()) {
+                params.push_back({keysetParameter(i), value.get<snowflake>()});
+            } else if (value.is_number()) {
+                params.push_back({keysetParameter(i), value.get<double>()});
+            } else if (value.is_string()) {
+                params.push_back(
+                    {keysetParameter(i), value.get<std::string>()});
+            } else {
+                throw std::runtime_error("Invalid page token value " +
+                                         value.dump());
+            }
+        }
+    }
+
+    void addKeysetOrderByClause(std::stringstream& sql,
+                                std::vector<KeysetKey>& keys) {
+        sql << " ORDER BY ";
+
+        for (size_t i = 0; i < keys.size(); i++) {
+            sql << keys[i].first << " "
+                << magic_enum::enum_name(keys[i].second);
+
+            if (i != keys.size() - 1) {
+                sql << ", ";
+            }
+        }
+    }
+
+    /**
+     * @brief reads the keys selected after the document properties
+     */
+    json readKeyset(IDBRowReader& row, int column,
+                    std::vector<SortedProperty>& sortBy) {
+        json keys = json::array();
+
+        for (auto& sorted : sortBy) {
+            if (row.isNull(column)) {
+                keys.push_back(nullptr);
+            } else {
+                switch (sorted.property.getType()) {
+                    case PropertyType::ID:
+                    case PropertyType::INTEGER:
+                    case PropertyType::BOOLEAN:
+                        keys.push_back(row.readInt64(column));
+                        break;
+                    case PropertyType::DOUBLE:
+                        keys.push_back(row.readDouble(column));
+                        break;
+                    default:
+                        keys.push_back(row.readString(column));
+                }
+            }
+
+            column++;
+        }
+
+        keys.push_back(row.readInt64(column));
+
+        return keys;
+    }
+
+    /* --------------------- SELECT PLAN -------------------- */
+    void addShape(std::stringstream& shape, const std::string& str) {
+        shape << str.size() << ':' << str;
+    }
+
+    void addShape(std::stringstream& shape, Property& prop) {
+        shape << "p(";
+
+        if (auto coll = prop.getParentCollName()) addShape(shape, *coll);
+
+        addShape(shape, prop.getName());
+        shape << prop.getId() << ',' << prop.getType() << ')';
+    }
+
+    void addShape(std::stringstream& shape, AggregatedProperty& agProp) {
+        shape << "a(" << agProp.type;
+        addShape(shape, agProp.property);
+        addShape(shape, agProp.alias);
+        shape << ')';
+    }
+
+    void addShape(std::stringstream& shape, Object& composed) {
+        shape << "o(" << composed.getCollId();
+        addShape(shape, composed.getPropertyRef());
+
+        for (auto& prop : composed.getPropertiesRef()) {
+            std::visit([&shape](auto& p) { addShape(shape, p); }, prop);
+        }
+
+        shape << ')';
+    }
+
+    void addShape(std::stringstream& shape, PropertyExpression& expr);
+
+    void addShape(std::stringstream& shape, PropertyExpressionOperand& expr) {
+        // the constants are parameters, only where they are matters
+        auto cbConstVal = overloaded {
+            [&shape](Property& prop) { addShape(shape, prop); },
+            [&shape](auto&) { shape << '?'; }};
+
+        auto cbOperand = overloaded {
+            [&cbConstVal](LogicConstValue& prop) {
+                std::visit(cbConstVal, prop);
+            },
+            [&shape](box<struct PropertyExpression>& agProp) {
+                addShape(shape, *agProp);
+            },
+            [&shape](PropertyExpressionOperand& agProp) {
+                addShape(shape, agProp);
+            }};
+
+        std::visit(cbOperand, expr);
+    }
+
+    void addShape(std::stringstream& shape, PropertyExpression& expr) {
+        shape << "e(" << expr.type;
+        addShape(shape, expr.left);
+
+        if (expr.type != PropertyExpressionOperator::NOT) {
+            addShape(shape, expr.right);
+        }
+
+        shape << ')';
+    }
+
+    /**
+     * @brief Describes everything the sql of a select depends on but the
+     * values that are bound to it. Two selects with the same shape and
+     * catalog version share the same plan.
+     */
+    std::string getSelectShape(QueryPlannerContextSelect& data,
+                               uint64_t catalogVersion) {
+        std::stringstream shape;
+
+        shape << catalogVersion << ';' << data.ThrowOnSelectMissingProperty
+              << data.removeInnerIDs << ";from:";
+
+        for (auto& coll : data.from) addShape(shape, coll.getName());
+
+        shape << ";select:";
+        for (auto& prop : data.select_value) {
+            std::visit([&shape](auto& p) { addShape(shape, p); }, prop);
+        }
+
+        shape << ";where:";
+        if (data.where_value) addShape(shape, data.where_value.value());
+
+        shape << ";group:";
+        for (auto& prop : data.groupBy_value) addShape(shape, prop);
+
+        shape << ";sort:";
+        for (auto& sorted : data.sortBy_value) {
+            shape << sorted.type;
+            addShape(shape, sorted.property);
+        }
+
+        shape << ";suppress:";
+        for (auto& prop : data.suppress_value) addShape(shape, prop);
+
+        shape << ";rename:";
+        for (auto& renamed : data.renamed_value) {
+            addShape(shape, renamed.prop);
+            addShape(shape, renamed.alias);
+        }
+
+        shape << ";page:" << data.pagination_value.has_value();
+
+        // the null values of the keyset are written in the sql
+        if (data.keyset_value) {
+            shape << ";keyset:" << data.keyset_value->before;
+
+            for (auto& value : data.keyset_value->keys) {
+                shape << (value.is_null() ? 'n' : 'v');
+            }
+        }
+
+        return shape.str();
+    }
+
+    /**
+     * @brief The values of a select plan parameters: the where constants,
+     * the keyset and the pagination.
+     */
+    Paramsbind bindSelectParameters(QueryPlannerContextSelect& data) {
+        Paramsbind params;
+
+        if (data.where_value) {
+            int bound = 0;
+            bindWhereConstants(data.where_value.value(), params, bound);
+        }
+
+        if (data.keyset_value) bindKeyset(data.keyset_value->keys, params);
+
+        if (data.pagination_value) bindPagination(data, params);
+
+        return params;
+    }
+
     /* ------------------- EXECUTE SELECT ------------------- */
     json QueryRunnerSQ3::select(QueryPlannerContextSelect&& data) {
+        json res = json::array();
+
+        stream(std::move(data), [&res](json& document) {
+            res.push_back(std::move(document));
+            return true;
+        });
+
+        return res;
+    }
+
+    long long QueryRunnerSQ3::stream(
+        QueryPlannerContextSelect&& data,
+        const std::function<bool(json&)>& onDocument) {
+        return runSelect(data,
+                         [&onDocument](json& document, IDBRowReader&, int) {
+                             return onDocument(document);
+                         });
+    }
+
+    SelectPage QueryRunnerSQ3::selectPage(QueryPlannerContextSelect&& data) {
+        if (!data.keyset_value) {
+            data.keyset_value = QueryKeyset {.keys = json::array()};
+        }
+
+        const bool before = data.keyset_value->before;
+        const bool fromStart = data.keyset_value->keys.empty();
+        const int limit = data.pagination_value
+                              ? data.pagination_value->elementsPerPage
+                              : 10;
+
+        // one more to know if there is another page
+        data.pagination_value = {.pageNumber = 1, .elementsPerPage = limit + 1};
+
+        SelectPage page;
+        std::vector<json> keys;
+        bool more = false;
+
+        runSelect(data, [&](json& document, IDBRowReader& row, int column) {
+            if ((int)keys.size() == limit) {
+                more = true;
+                return false;
+            }
+
+            page.documents.push_back(std::move(document));
+            keys.push_back(readKeyset(row, column, data.sortBy_value));
+            return true;
+        });
+
+        if (keys.empty()) return page;
+
+        if (before) {
+            std::reverse(page.documents.begin(), page.documents.end());
+            std::reverse(keys.begin(), keys.end());
+        }
+
+        // it came from the page after/before the keyset
+        if (before || more) page.next = keys.back().dump();
+        if (before ? more : !fromStart) page.previous = keys.front().dump();
+
+        return page;
+    }
+
+    long long QueryRunnerSQ3::runSelect(QueryPlannerContextSelect& data,
+                                        const RowCallback& onRow) {
         NLDB_PROFILE_BEGIN_SESSION("select", "nldb-profile-select.json");
 
-        json res;
+        long long res = 0;
 
         {
-            std::lock_guard<std::mutex> lock(this->repos->mtx);
+            std::lock_guard<std::recursive_mutex> lock(this->repos->mtx);
 
             this->repos->pushPendingData();
 
@@ -1159,65 +1600,604 @@ namespace nldb {
             // Check if the root collection exists
             const std::string rootCollName = data.from.begin()->getName();
             auto rootColFound = repos->repositoryCollection->find(rootCollName);
-            if (!rootColFound) return res = json::array();  // empty array
+            if (!rootColFound) return 0;
 
-            if (data.ThrowOnSelectMissingProperty) {
-                populateData<DoThrow>(data);
-            } else {
-                populateData<DoNotThrow>(data);
-            }
+            std::string shape;
+            std::shared_ptr<SelectPlan> plan;
 
-            selectAllOnEmpty(data, repos);
+            if (repos->selectPlans) {
+                shape = getSelectShape(data, repos->getCatalogVersion());
 
-            // don't do it before selectAllOnEmpty because we might remove all
-            if (!data.ThrowOnSelectMissingProperty) {
-                removeMissingProperties(data);
+                if (repos->selectPlans->plans.contains(shape)) {
+                    plan = repos->selectPlans->plans.get(shape);
+                }
             }
 
-            // there are no properties for this collection yet
-            if (data.select_value.empty())
-                return res = json::array();  // empty array
+            if (plan) {
+                // the keys are read with the sorted properties found
+                if (data.keyset_value) data.sortBy_value = plan->sortBy;
+            } else {
+                const size_t parameters = bindSelectParameters(data).size();
 
-            std::stringstream sql;
+                plan = buildSelectPlan(data);
 
-            auto rootColl = repos->repositoryCollection->find(rootCollName);
+                // there are no properties for this collection yet
+                if (!plan) return 0;
 
-            if (!rootColl) {
-                return {};  // the collection doesn't even exists
+                // unless a missing property took a constant out of the where,
+                // the same values are bound to the same parameters
+                if (repos->selectPlans &&
+                    bindSelectParameters(data).size() == parameters) {
+                    repos->selectPlans->plans.insert(shape, plan);
+                }
             }
 
-            QueryRunnerCtx ctx(
-                rootColl->getId(),
-                repos->repositoryCollection->getOwnerId(rootColl->getId())
-                    .value_or(-1),
-                doc_alias);
+            // execute it
+            res = readQuery(*plan, bindSelectParameters(data), connection,
+                            onRow);
+        }
+
+        NLDB_PROFILE_END_SESSION();
+        return res;
+    }
+
+    std::shared_ptr<SelectPlan> QueryRunnerSQ3::buildSelectPlan(
+        QueryPlannerContextSelect& data) {
+        NLDB_PROFILE_FUNCTION();
+
+        if (data.ThrowOnSelectMissingProperty) {
+            populateData<DoThrow>(data);
+        } else {
+            populateData<DoNotThrow>(data);
+        }
+
+        selectAllOnEmpty(data, repos);
+
+        // don't do it before selectAllOnEmpty because we might remove all
+        if (!data.ThrowOnSelectMissingProperty) {
+            removeMissingProperties(data);
+        }
+
+        if (data.select_value.empty()) return nullptr;
+
+        std::stringstream sql;
+
+        auto rootColl =
+            repos->repositoryCollection->find(data.from.begin()->getName());
+
+        if (!rootColl) {
+            return nullptr;  // the collection doesn't even exists
+        }
+
+        QueryRunnerCtx ctx(
+            rootColl->getId(),
+            repos->repositoryCollection->getOwnerId(rootColl->getId())
+                .value_or(-1),
+            doc_alias);
 
-            expandRootProperty(repos, data.select_value, ctx);
-            expandObjectProperties(repos, data.select_value);
-            suppressFields(data.select_value, data.suppress_value,
-                           data.removeInnerIDs);
-            filterOutEmptyObjects(data.select_value);
+        // the values are bound on each execution
+        ctx.bindConstants = true;
 
-            moveInnerPropsToTheirSubObjects(data.select_value, repos, ctx);
-            addUsedFields(data, repos, ctx, data.suppress_value);
+        expandRootProperty(repos, data.select_value, ctx);
+        expandObjectProperties(repos, data.select_value);
+        suppressFields(data.select_value, data.suppress_value,
+                       data.removeInnerIDs);
+        filterOutEmptyObjects(data.select_value);
+
+        moveInnerPropsToTheirSubObjects(data.select_value, repos, ctx);
+        addUsedFields(data, repos, ctx, data.suppress_value);
 
 #ifdef NLDB_DEBUG_QUERY
-            printSelect(data.select_value);
+        printSelect(data.select_value);
 #endif
 
-            addSelectClause(sql, data.select_value, ctx);
+        addSelectClause(sql, data.select_value, ctx);
+
+        if (data.keyset_value) {
+            if (!data.groupBy_value.empty()) {
+                throw std::runtime_error(
+                    "Groups can't be read after or before another one");
+            }
+
+            auto keys = getKeyset(data, ctx);
+
+            addKeysetSelectClause(sql, keys);
+            addFromClause(sql, data, ctx);
+            addWhereClause(sql, data, ctx);
+            addKeysetWhereClause(sql, keys, data.keyset_value->keys);
+            addKeysetOrderByClause(sql, keys);
+        } else {
             addFromClause(sql, data, ctx);
             addWhereClause(sql, data, ctx);
             addGroupByClause(sql, data.groupBy_value, ctx);
             addOrderByClause(sql, data.sortBy_value, ctx);
-            if (data.pagination_value)
-                addPaginationClause(sql, data.pagination_value.value());
+        }
 
-            // execute it
-            res = readQuery(sql, connection, data);
+        if (data.pagination_value) addPaginationClause(sql);
+
+        // the sorted properties are still needed to read the keys of a page
+        return std::make_shared<SelectPlan>(
+            SelectPlan {.sql = sql.str(),
+                        .columns = std::move(data.select_value),
+                        .suppressed = std::move(data.suppress_value),
+                        .renamed = std::move(data.renamed_value),
+                        .sortBy = data.sortBy_value});
+    }
+
+    /* ------------------- UPDATE BY WHERE ------------------ */
+    const std::string matched_ids_table = "temp.nldb_matched_ids";
+
+    std::string QueryRunnerSQ3::selectMatching(QueryPlannerContextWhere& data,
+                                               const Collection& rootColl,
+                                               const std::string& columns,
+                                               Paramsbind& params) {
+        QueryPlannerContextSelect select(
+            QueryPlannerContext {.from = data.from,
+                                 .queryRunner = nullptr,
+                                 .ThrowOnSelectMissingProperty = true});
+        select.where_value = data.where_value;
+
+        // a missing property would erase its condition, matching documents
+        // that shouldn't.
+        populateData<DoThrow>(select);
+
+        QueryRunnerCtx ctx(
+            rootColl.getId(),
+            repos->repositoryCollection->getOwnerId(rootColl.getId())
+                .value_or(-1),
+            doc_alias);
+
+        // the same statement is reused with other values, as the selects
+        ctx.bindConstants = true;
+
+        // join the properties used in the where
+        std::vector<Property> suppressed;
+        addUsedFields(select, repos, ctx, suppressed);
+
+        std::stringstream sql;
+        sql << "select " << columns << " ";
+        addFromClause(sql, select, ctx);
+        addWhereClause(sql, select, ctx);
+
+        if (select.where_value) {
+            int bound = 0;
+            bindWhereConstants(select.where_value.value(), params, bound);
+        }
+
+        return sql.str();
+    }
+
+    int QueryRunnerSQ3::storeMatchingIds(QueryPlannerContextWhere& data,
+                                         const Collection& rootColl) {
+        Paramsbind params;
+        const std::string sql =
+            "insert or ignore into " + matched_ids_table + " " +
+            selectMatching(data, rootColl, std::string(doc_alias) + ".id",
+                           params);
+
+        connection->execute(
+            "create temp table if not exists nldb_matched_ids (id INTEGER "
+            "PRIMARY KEY);",
+            {});
+        connection->execute("delete from " + matched_ids_table + ";", {});
+        connection->execute(sql, params);
+
+        return connection->getChangesCount().value_or(0);
+    }
+
+    inline ParamsBindValue toBindValue(json& value, PropertyType type) {
+        switch (type) {
+            case PropertyType::INTEGER:
+                return value.get<snowflake>();
+            case PropertyType::BOOLEAN:
+                return value.get<bool>() ? 1 : 0;
+            case PropertyType::DOUBLE:
+                return value.get<double>();
+            default:
+                return ValueToString(value);
+        }
+    }
+
+    /**
+     * @brief Throws if applying the operator to the value of any of the
+     * objects would overflow it.
+     */
+    inline void CheckIntegerOperator(IDB* connection, UpdateOperator op,
+                                     snowflake propID,
+                                     const std::string& propName,
+                                     const std::string& objects,
+                                     int64_t operand) {
+        const std::string sql =
+            "select count(*) from value_int where prop_id = @prop_id and "
+            "obj_id in (@objects) and not " +
+            definitions::getIntegerOperatorGuard(op, "@value") + ";";
+
+        const int overflowing =
+            connection
+                ->executeAndGetFirstInt(
+                    parseSQL(sql, {{"@objects", objects}}, false),
+                    {{"@prop_id", propID}, {"@value", operand}})
+                .value_or(0);
+
+        if (overflowing > 0) {
+            throw InvalidUpdate("the integer overflows, property " + propName);
+        }
+    }
+
+    void QueryRunnerSQ3::updateMatchingRecursive(const Collection& collection,
+                                                 json& object,
+                                                 const std::string& objects) {
+        // without the "where" the parser takes "on conflict" as a join
+        // constraint
+        static const definitions::tables::TableQuery upsertSql(
+            "insert into @table (obj_id, prop_id, value) select m.id, "
+            "@prop_id, @value from (@objects) as m where true on conflict "
+            "(obj_id, prop_id) do update set value = excluded.value;");
+
+        static const definitions::tables::TableQuery operatorSql(
+            "insert into @table (obj_id, prop_id, value) select m.id, "
+            "@prop_id, @value from (@objects) as m where true on conflict "
+            "(obj_id, prop_id) do update set value = @expression;");
+
+        for (auto& [propName, valueJson] : object.items()) {
+            if (propName == common::internal_id_string) continue;
+
+            if (IsUpdateOperation(valueJson)) {
+                for (auto& [key, operand] : valueJson.items()) {
+                    const UpdateOperator op = FindUpdateOperator(key).value();
+                    const std::string expression =
+                        definitions::getOperatorExpression(op);
+
+                    PropertyType type;
+                    const snowflake propID = findOrAddOperatorProperty(
+                        collection.getId(), propName, operand, type);
+
+                    // check every object before changing any of them
+                    if (type == PropertyType::INTEGER) {
+                        CheckIntegerOperator(connection, op, propID, propName,
+                                             objects, operand.get<int64_t>());
+                    }
+
+                    connection->execute(
+                        parseSQL(operatorSql[type],
+                                 {{"@objects", objects},
+                                  {"@expression", expression}},
+                                 false),
+                        {{"@prop_id", propID},
+                         {"@value", toBindValue(operand, type)}});
+                }
+
+                continue;
+            }
+
+            auto type = JsonTypeToPropertyType((int)valueJson.type());
+
+            // same as updating by id, null values are skipped
+            if (type == PropertyType::_NULL) continue;
+
+            const snowflake propID =
+                findOrAddProperty(collection.getId(), propName, type);
+
+            if (type != PropertyType::OBJECT) {
+                connection->execute(
+                    parseSQL(upsertSql[type], {{"@objects", objects}}, false),
+                    {{"@prop_id", propID},
+                     {"@value", toBindValue(valueJson, type)}});
+
+                continue;
+            }
+
+            // add the sub-objects to the objects that don't have it yet
+            auto subColl = repos->repositoryCollection->findByOwner(propID);
+
+            if (!subColl) {
+                const std::string name = common::getSubCollectionName(
+                    collection.getName(), propName);
+
+                subColl = Collection(
+                    repos->repositoryCollection->add(name, propID), name);
+                repos->catalogChanged();
+            }
+
+            auto reader = connection->executeReader(
+                parseSQL("select m.id from (@objects) as m where not exists "
+                         "(select 1 from object as o where o.prop_id = "
+                         "@prop_id and o.obj_id = m.id);",
+                         {{"@objects", objects}, {"@prop_id", propID}}, false),
+                {});
+
+            bool added = false;
+            std::shared_ptr<IDBRowReader> row;
+            while (reader->readRow(row)) {
+                repos->valuesDAO->addObject(propID, row->readInt64(0));
+                added = true;
+            }
+
+            reader.reset();
+
+            // they are buffered, and the values are updated without the
+            // buffers
+            if (added) {
+                repos->pushPendingData();
+                repos->commitPendingData();
+            }
+
+            updateMatchingRecursive(
+                subColl.value(), valueJson,
+                parseSQL("select id from object where prop_id = @prop_id and "
+                         "obj_id in (@objects)",
+                         {{"@prop_id", propID}, {"@objects", objects}}, false));
+        }
+    }
+
+    int QueryRunnerSQ3::update(QueryPlannerContextUpdateWhere&& data) {
+        NLDB_PROFILE_BEGIN_SESSION("update", "nldb-profile-update.json");
+
+        int updated = 0;
+
+        {
+            NLDB_PROFILE_FUNCTION();
+
+            std::lock_guard<std::recursive_mutex> lock(this->repos->mtx);
+
+            NLDB_ASSERT(data.from.size() > 0, "missing target collection");
+
+            // the documents could still be buffered, and a failed flush
+            // shouldn't roll back the update
+            this->repos->pushPendingData();
+            this->repos->commitPendingData();
+
+            auto rootColl =
+                repos->repositoryCollection->find(data.from.begin()->getName());
+
+            // no documents to update
+            if (!rootColl) return 0;
+
+            updated = storeMatchingIds(data, rootColl.value());
+
+            if (updated > 0) {
+                // update all of them or none, with the collections and
+                // properties it adds. If the user has a transaction open,
+                // it's up to them to roll it back.
+                std::optional<Transaction> transaction;
+                if (!connection->isInTransaction()) {
+                    transaction.emplace(connection, repos);
+                }
+
+                updateMatchingRecursive(rootColl.value(), data.object,
+                                        "select id from " + matched_ids_table);
+
+                if (transaction) {
+                    transaction->commit();
+                } else {
+                    this->repos->pushPendingData();
+                }
+            }
         }
 
         NLDB_PROFILE_END_SESSION();
-        return res;
+        return updated;
+    }
+
+    /* ------------------- REMOVE BY WHERE ------------------ */
+    const std::string removed_ids_table = "temp.nldb_removed_ids";
+
+    int QueryRunnerSQ3::remove(QueryPlannerContextRemoveWhere&& data) {
+        static const definitions::tables::TableQuery removeValuesSql(
+            "delete from @table where obj_id in (select id from " +
+            removed_ids_table + ");");
+
+        std::lock_guard<std::recursive_mutex> lock(this->repos->mtx);
+
+        NLDB_ASSERT(data.from.size() > 0, "missing target collection");
+
+        // the documents could still be buffered, and a failed flush shouldn't
+        // roll back the removal
+        this->repos->pushPendingData();
+        this->repos->commitPendingData();
+
+        auto rootColl =
+            repos->repositoryCollection->find(data.from.begin()->getName());
+
+        // no documents to remove
+        if (!rootColl) return 0;
+
+        const int removed = storeMatchingIds(data, rootColl.value());
+
+        if (removed == 0) return 0;
+
+        // the documents and their sub-documents, at any depth
+        connection->execute(
+            "create temp table if not exists nldb_removed_ids (id INTEGER "
+            "PRIMARY KEY);",
+            {});
+
+        // remove all of them or none
+        const bool ownTransaction = !connection->isInTransaction();
+        if (ownTransaction) connection->begin();
+
+        try {
+            connection->execute("delete from " + removed_ids_table + ";", {});
+            connection->execute(
+                "with recursive tree(id) as (select id from " +
+                    matched_ids_table +
+                    " union all select o.id from object as o join tree as t "
+                    "on o.obj_id = t.id) insert into " +
+                    removed_ids_table + " select id from tree;",
+                {});
+
+            // BOOLEAN shares the table with INTEGER
+            for (auto type : {PropertyType::STRING, PropertyType::INTEGER,
+                              PropertyType::DOUBLE, PropertyType::ARRAY}) {
+                connection->execute(removeValuesSql[type], {});
+            }
+
+            connection->execute(
+                "delete from object where id in (select id from " +
+                    removed_ids_table + ");",
+                {});
+        } catch (...) {
+            if (ownTransaction) connection->rollback();
+            throw;
+        }
+
+        if (ownTransaction) connection->commit();
+
+        return removed;
+    }
+
+    /* ------------------- COUNT BY WHERE ------------------- */
+    long long QueryRunnerSQ3::count(QueryPlannerContextCountWhere&& data) {
+        std::lock_guard<std::recursive_mutex> lock(this->repos->mtx);
+
+        NLDB_ASSERT(data.from.size() > 0, "missing target collection");
+
+        // the documents could still be buffered
+        this->repos->pushPendingData();
+
+        auto rootColl =
+            repos->repositoryCollection->find(data.from.begin()->getName());
+
+        // no documents to count
+        if (!rootColl) return 0;
+
+        Paramsbind params;
+
+        if (data.onlyExists) {
+            const std::string sql =
+                selectMatching(data, rootColl.value(), "1", params);
+
+            auto found = connection->executeAndGetFirstInt(sql + " limit 1;",
+                                                           params);
+
+            return found.has_value() ? 1 : 0;
+        }
+
+        const std::string sql =
+            selectMatching(data, rootColl.value(), "count(*)", params);
+
+        return connection->executeAndGetFirstInt(sql + ";", params)
+            .value_or(0);
+    }
+
+    /* --------------------- GET BY ID ---------------------- */
+    std::string joinIds(const auto& ids) {
+        std::string list;
+
+        for (const snowflake id : ids) {
+            if (!list.empty()) list += ',';
+            list += std::to_string(id);
+        }
+
+        return list;
+    }
+
+    json QueryRunnerSQ3::get(QueryPlannerContextGet&& data) {
+        std::lock_guard<std::recursive_mutex> lock(this->repos->mtx);
+
+        NLDB_ASSERT(data.from.size() > 0, "missing target collection");
+
+        json documents = json::array();
+
+        if (data.documentIDs.empty()) return documents;
+
+        // the documents could still be buffered
+        this->repos->pushPendingData();
+
+        auto rootColl =
+            repos->repositoryCollection->find(data.from.begin()->getName());
+
+        if (!rootColl) return documents;
+
+        auto rootPropID =
+            repos->repositoryCollection->getOwnerId(rootColl->getId());
+
+        if (!rootPropID) return documents;
+
+        struct Node {
+            // object that holds this one, none on the documents
+            std::optional<snowflake> parent;
+            std::string name;
+            json value;
+
+            bool added {false};
+        };
+
+        std::unordered_map<snowflake, Node> nodes;
+
+        // the deepest objects first, so they are complete by the time they
+        // are moved into their parent
+        std::vector<snowflake> deepestFirst;
+
+        auto reader = connection->executeReader(
+            parseSQL(
+                "with recursive tree(id, obj_id, prop_id, depth) as (select "
+                "id, obj_id, prop_id, 0 from object where prop_id = "
+                "@root_prop_id and id in (@ids) union all select o.id, "
+                "o.obj_id, o.prop_id, t.depth + 1 from object as o join tree "
+                "as t on o.obj_id = t.id) select t.id, t.obj_id, p.name from "
+                "tree as t join property as p on p.id = t.prop_id order by "
+                "t.depth desc;",
+                {{"@ids", joinIds(data.documentIDs)}}, false),
+            {{"@root_prop_id", rootPropID.value()}});
+
+        std::shared_ptr<IDBRowReader> row;
+        while (reader->readRow(row)) {
+            const snowflake id = row->readInt64(0);
+
+            Node& node = nodes[id];
+            if (!row->isNull(1)) node.parent = row->readInt64(1);
+            node.name = row->readString(2);
+
+            deepestFirst.push_back(id);
+        }
+
+        if (nodes.empty()) return documents;
+
+        // one scan of the obj_id index per value table, BOOLEAN shares the
+        // table with INTEGER
+        static const definitions::tables::TableQuery valuesSql(
+            "select v.obj_id, p.name, p.type, v.value from @table as v join "
+            "property as p on p.id = v.prop_id where v.obj_id in (@objects);");
+
+        const std::string objects = joinIds(deepestFirst);
+
+        for (auto type : {PropertyType::STRING, PropertyType::INTEGER,
+                          PropertyType::DOUBLE, PropertyType::ARRAY}) {
+            auto values = connection->executeReader(
+                parseSQL(valuesSql[type], {{"@objects", objects}}, false), {});
+
+            // a row reads from the statement it was created for
+            row.reset();
+            while (values->readRow(row)) {
+                read(row, (PropertyType)row->readInt32(2),
+                     nodes[row->readInt64(0)].value, row->readString(1), 3);
+            }
+        }
+
+        // like select, sub-objects without values are left out
+        for (const snowflake id : deepestFirst) {
+            Node& node = nodes[id];
+
+            if (node.parent && !node.value.is_null()) {
+                nodes[node.parent.value()].value[node.name] =
+                    std::move(node.value);
+            }
+        }
+
+        for (const snowflake id : data.documentIDs) {
+            auto found = nodes.find(id);
+
+            // not a document of this collection, or a repeated id
+            if (found == nodes.end() || found->second.added) continue;
+
+            json& document = found->second.value;
+            document[common::internal_id_string] = std::to_string(id);
+
+            documents.push_back(std::move(document));
+            found->second.added = true;
+        }
+
+        return documents;
     }
-}  // namespace nldb
\ No newline at end of file
+}  // namespace nldb
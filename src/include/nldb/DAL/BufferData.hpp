@@ -1,16 +1,41 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
 #include "nldb/DB/IDB.hpp"
 #include "nldb/Property/Property.hpp"
 #include "nldb/Utils/ValueBuffer.hpp"
 #include "nldb/typedef.hpp"
 
 namespace nldb {
+    // The strings of the buffered values are copied into the arena of their
+    // buffer when added, so they only need to be valid until then.
+
     struct BufferValueStringLike {
         snowflake propID;
         snowflake objID;
         PropertyType type;
-        std::string value;
+        std::string_view value;
+    };
+
+    // integers and booleans, which are stored as 0 or 1
+    struct BufferValueInteger {
+        snowflake propID;
+        snowflake objID;
+        int64_t value;
+    };
+
+    struct BufferValueDouble {
+        snowflake propID;
+        snowflake objID;
+        double value;
     };
 
     struct BufferValueDependentObject {
@@ -26,34 +51,165 @@ namespace nldb {
 
     struct BufferValueRootProperty {
         snowflake id;
-        std::string name;
+        std::string_view name;
     };
 
     struct BufferValueProperty {
         snowflake id;
-        std::string name;
+        std::string_view name;
         snowflake coll_id;
         PropertyType type;
     };
 
     struct BufferValueCollection {
         snowflake id;
-        std::string name;
+        std::string_view name;
         snowflake owner_id;
     };
 
     struct BufferData {
+        /**
+         * @brief While alive, the values and objects added by the thread that
+         * created it are kept in buffers of its own instead of the shared
+         * ones, so adding them takes no lock. `merge` moves them into the
+         * shared buffers at once, holding the operations lock so no flush
+         * takes only part of them. What's not merged is discarded with it.
+         *
+         * It also merges on its own once one of its buffers holds as many
+         * elements as the shared one fits.
+         */
+        class Staging {
+           public:
+            Staging(BufferData& owner);
+            ~Staging();
+
+            Staging(const Staging&) = delete;
+            Staging& operator=(const Staging&) = delete;
+
+            void merge();
+
+           private:
+            friend struct BufferData;
+
+            template <typename T, typename L>
+            void inline add(std::vector<T>& staged, const T& val,
+                            DoubleBuffer<T, L>& shared) {
+                staged.push_back(val);
+
+                if (staged.size() >= (size_t)shared.Capacity()) merge();
+            }
+
+            void clear();
+
+           private:
+            BufferData& owner;
+
+            std::vector<BufferValueStringLike> stringLike;
+            std::vector<BufferValueInteger> integer;
+            std::vector<BufferValueDouble> doubles;
+            std::vector<BufferValueDependentObject> dependentObject;
+            std::vector<BufferValueIndependentObject> independentObject;
+
+            // holds the strings of `stringLike`
+            StringArena arena;
+
+            // staging of this thread before this one, if any
+            Staging* previous;
+        };
+
+        /**
+         * @param FlushesPerCommit number of flushes that share a single
+         * transaction, see `pushPendingData`.
+         * @param CommitMaxDelayMs the transaction of the coalesced flushes is
+         * committed once it's been open for this long, even if fewer flushes
+         * used it.
+         */
         BufferData(IDB* db, int SmallBufferSize, int MediumBufferSize,
-                   int LargeBufferSize);
+                   int LargeBufferSize, int FlushesPerCommit = 1,
+                   int CommitMaxDelayMs = 1000);
 
         /**
          * @brief if there is data pending to be sent, make sure it is sent.
+         *
+         * The buffers are frozen and written while new data keeps being
+         * added to their other half, only one flush runs at a time.
+         * All the buffers are written in a single transaction, if any of them
+         * fails nothing is written and the buffered data is discarded.
+         * If `FlushesPerCommit` is greater than 1, the transaction is left
+         * open and committed by the last of those flushes, by the first flush
+         * after `CommitMaxDelayMs`, or by `commitPendingData`. Coalesced
+         * flushes are committed or rolled back together, so anything written
+         * without the buffers must call `commitPendingData` first.
+         * If a transaction was already open, the data is written in it.
          */
         void pushPendingData();
 
+        /**
+         * @brief Commits the flushes that were waiting for others to share
+         * their transaction. Call it before writing anything that doesn't go
+         * through the buffers, or a later failed flush would roll it back.
+         */
+        void commitPendingData();
+
+        /**
+         * @brief Writes the pending data, only if a value of the property of
+         * the object is still buffered, and commits. Call it before
+         * combining the stored value without the buffers.
+         */
+        void pushPendingValue(snowflake propID, snowflake objID);
+
+        /**
+         * @brief Drops the data that was not written yet.
+         */
+        void discardPendingData();
+
+        /**
+         * @brief Pushes the pending data, or lets the background flusher do
+         * it if it's running.
+         */
+        void schedulePendingData();
+
+        /**
+         * @brief Starts a thread that flushes the buffers, so the threads
+         * adding data don't need to do it.
+         *
+         * @param maxLatency flush at least this often
+         * @param fillRatio flush once a buffer is filled up to this ratio
+         * @param highWatermark from this ratio on the thread adding the data
+         * flushes it itself instead of waiting for the background flusher.
+         *
+         * The flusher takes the operations lock while freezing the buffers,
+         * so it doesn't freeze half of an operation, and releases it while
+         * writing them. See `setOperationLock`.
+         *
+         * If a flush fails its data is discarded and the first error is
+         * thrown by the next `pushPendingData` or `schedulePendingData`.
+         */
+        void startBackgroundFlusher(std::chrono::milliseconds maxLatency,
+                                    double fillRatio, double highWatermark);
+
+        /**
+         * @brief Stops the background flusher, if running, and waits for it.
+         * The remaining data is not flushed.
+         */
+        void stopBackgroundFlusher();
+
+        /**
+         * @brief Sets a callback to call when a flush fails and the buffered
+         * data gets discarded.
+         */
+        void setOnDiscard(std::function<void()> callback);
+
+        /**
+         * @brief Sets the lock held by every operation on the database, taken
+         * by the background flusher and by `Staging::merge`.
+         */
+        void setOperationLock(std::recursive_mutex* operationLock);
+
         /**
          * @brief add a value to the buffer, it might flush if there is not
-         * enough space.
+         * enough space. The values and objects go to the Staging of the
+         * calling thread instead, if it has one.
          *
          * @param val value to add
          */
@@ -61,44 +217,160 @@ namespace nldb {
         void add(const BufferValueRootProperty& val);
         void add(const BufferValueProperty& val);
         void add(const BufferValueStringLike& val);
+        void add(const BufferValueInteger& val);
+        void add(const BufferValueDouble& val);
         void add(const BufferValueDependentObject& val);
         void add(const BufferValueIndependentObject& val);
 
         virtual ~BufferData();
 
        protected:
-        template <typename T, typename L>
-        void inline _add(const T& val, Buffer<T, L>& buff) {
-            if (!buff.Add(val)) {
-                this->pushPendingData();
-                buff.Add(val);
+        /**
+         * @brief Freezes all the buffers, see DoubleBuffer.
+         *
+         * @return true if there is something to write.
+         */
+        bool freezeBuffers();
+
+        /**
+         * @brief Writes the frozen buffers, `lock` must be held. On failure
+         * everything is discarded and the exception is rethrown, the caller
+         * should call `onDiscard`.
+         */
+        void writeFrozenData();
+
+        /**
+         * @brief Freezes and writes the buffers, `lock` must be held.
+         */
+        void flushLocked();
+
+        void commitTransaction();
+
+        // the coalesced flushes waited too long to be committed
+        bool isTransactionOverdue() const;
+
+        /**
+         * @brief Throws the error of a failed background flush, if any, only
+         * once. `lock` must be held.
+         */
+        void throwFlushError();
+
+        void resetBuffers();
+
+        template <typename T, typename L, typename... Payload>
+        void inline _add(const T& val, DoubleBuffer<T, L>& buff,
+                         Payload... payload) {
+            if (!buff.Add(val, payload...)) {
+                // many threads can find it full, only the first one flushes
+                while (!buff.Add(val, payload...)) {
+                    std::lock_guard<std::mutex> guard(lock);
+
+                    if (buff.Size() >= buff.Capacity()) flushLocked();
+                }
+
+                return;
+            }
+
+            checkFill(buff.Size() / (double)buff.Capacity());
+        }
+
+        /**
+         * @brief Adds all the staged elements, flushing the buffer each time
+         * it's full.
+         *
+         * @return double how full the buffer is left
+         */
+        template <typename T, typename L, typename... Payload>
+        double inline _addStaged(const std::vector<T>& staged,
+                                 DoubleBuffer<T, L>& buff,
+                                 Payload... payload) {
+            auto next = buff.AddMany(staged.begin(), staged.end(), payload...);
+
+            while (next != staged.end()) {
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+
+                    if (buff.Size() >= buff.Capacity()) flushLocked();
+                }
+
+                next = buff.AddMany(next, staged.end(), payload...);
             }
+
+            return buff.Size() / (double)buff.Capacity();
         }
 
+        /**
+         * @brief Moves the elements of a staging into the buffers, see
+         * `Staging::merge`.
+         */
+        void mergeStaging(Staging& staging);
+
+        // the staging of the current thread, if it's adding to this one
+        Staging* currentStaging();
+
+        // flushes or wakes up the background flusher by how full a buffer is
+        void checkFill(double fill);
+
+        void requestBackgroundFlush();
+
+        void runBackgroundFlusher();
+
        protected:
         // Property collection
-        Buffer<BufferValueCollection, std::mutex> bufferCollection;
+        DoubleBuffer<BufferValueCollection, std::mutex> bufferCollection;
 
         // Property repo
-        Buffer<BufferValueRootProperty, std::mutex> bufferRootProperty;
-        Buffer<BufferValueProperty, std::mutex> bufferProperty;
+        DoubleBuffer<BufferValueRootProperty, std::mutex> bufferRootProperty;
+        DoubleBuffer<BufferValueProperty, std::mutex> bufferProperty;
 
         // Values DAO
-        Buffer<BufferValueStringLike, std::mutex> bufferStringLike;
-        Buffer<BufferValueDependentObject, std::mutex> bufferDependentObject;
-        Buffer<BufferValueIndependentObject, std::mutex>
+        DoubleBuffer<BufferValueStringLike, std::mutex> bufferStringLike;
+        DoubleBuffer<BufferValueInteger, std::mutex> bufferInteger;
+        DoubleBuffer<BufferValueDouble, std::mutex> bufferDouble;
+        DoubleBuffer<BufferValueDependentObject, std::mutex>
+            bufferDependentObject;
+        DoubleBuffer<BufferValueIndependentObject, std::mutex>
             bufferIndependentObject;
 
+        // held while freezing and writing the buffers
         std::mutex lock;
 
         IDB* conn;
 
+        // transaction left open by a flush, to coalesce it with the next ones
+        bool transactionOpen {false};
+        int flushesPerCommit;
+        int uncommittedFlushes {0};
+        std::chrono::milliseconds commitMaxDelay;
+        std::chrono::steady_clock::time_point transactionStart;
+
+        std::function<void()> onDiscard;
+
+        // background flusher
+        std::thread flusher;
+        std::mutex flusherMtx;
+        std::condition_variable flusherCv;
+        bool flushRequested {false};
+        bool stopFlusher {false};
+        // first error of a background flush, guarded by `lock`
+        std::exception_ptr flushError;
+        std::chrono::milliseconds flushMaxLatency;
+        double fillRatio {1};
+        double highWatermark {1};
+        std::recursive_mutex* operationLock {nullptr};
+
        private:
+        // they write the frozen half of their buffer
         virtual void pushRootProperties() = 0;
         virtual void pushCollections() = 0;
         virtual void pushProperties() = 0;
         virtual void pushIndependentObjects() = 0;
         virtual void pushDependentObjects() = 0;
+
+        // a value replaces the one its object already has for the property,
+        // so the same buffers hold inserts and updates
         virtual void pushStringLikeValues() = 0;
+        virtual void pushIntegerValues() = 0;
+        virtual void pushDoubleValues() = 0;
     };
 }  // namespace nldb
\ No newline at end of file
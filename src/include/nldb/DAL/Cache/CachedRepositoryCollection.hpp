@@ -18,6 +18,7 @@ namespace nldb {
         std::optional<Collection> findByOwner(snowflake ownerID) override;
         std::optional<snowflake> getOwnerId(snowflake collID) override;
         std::vector<Collection> getAll(bool onlyRootCollection) override;
+        void clearCache() override;
 
        private:
         std::unique_ptr<IRepositoryCollection> repo;
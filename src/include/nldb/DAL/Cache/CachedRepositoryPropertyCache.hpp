@@ -26,6 +26,7 @@ namespace nldb {
         bool exists(snowflake collectionID,
                     const std::string& propName) override;
         std::vector<Property> findAll(snowflake collectionId) override;
+        void clearCache() override;
 
        private:
         std::unique_ptr<IRepositoryProperty> repo;
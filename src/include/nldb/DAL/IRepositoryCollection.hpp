@@ -26,6 +26,12 @@ namespace nldb {
         virtual std::optional<snowflake> getOwnerId(snowflake collID) = 0;
         virtual std::vector<Collection> getAll(bool onlyRootCollection) = 0;
 
+        /**
+         * @brief Forgets the cached data, if any. Needed when the data it
+         * was read from is discarded, e.g. after a rollback.
+         */
+        virtual void clearCache() {}
+
         virtual ~IRepositoryCollection() = default;
     };
 }  // namespace nldb
\ No newline at end of file
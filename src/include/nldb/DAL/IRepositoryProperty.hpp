@@ -21,6 +21,12 @@ namespace nldb {
                             const std::string& propName) = 0;
         virtual std::vector<Property> findAll(snowflake collectionId) = 0;
 
+        /**
+         * @brief Forgets the cached data, if any. Needed when the data it
+         * was read from is discarded, e.g. after a rollback.
+         */
+        virtual void clearCache() {}
+
         virtual ~IRepositoryProperty() = default;
     };
 }  // namespace nldb
\ No newline at end of file
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <cstdint>
 #include <optional>
+#include <string_view>
+#include <vector>
 
+#include "nldb/DAL/UpdateOperator.hpp"
 #include "nldb/Property/Property.hpp"
 #include "nldb/typedef.hpp"
 
@@ -15,10 +19,33 @@ namespace nldb {
          * @param propID
          * @param objID
          * @param type any type but OBJECT is allowed.
-         * @param value
+         * @param value only needs to be valid during the call
          */
         virtual void addStringLike(snowflake propID, snowflake objID,
-                                   PropertyType type, std::string value) = 0;
+                                   PropertyType type,
+                                   std::string_view value) = 0;
+
+        /**
+         * @brief Adds a new INTEGER or BOOLEAN value to an object, without
+         * converting it to a string.
+         *
+         * @param propID
+         * @param objID
+         * @param value booleans are stored as 0 or 1
+         */
+        virtual void addInteger(snowflake propID, snowflake objID,
+                                int64_t value) = 0;
+
+        /**
+         * @brief Adds a new DOUBLE value to an object, without converting it
+         * to a string.
+         *
+         * @param propID
+         * @param objID
+         * @param value
+         */
+        virtual void addDouble(snowflake propID, snowflake objID,
+                               double value) = 0;
 
         /**
          * @brief Adds a new object.
@@ -51,7 +78,65 @@ namespace nldb {
          * @param value
          */
         virtual void updateStringLike(snowflake propID, snowflake objID,
-                                      PropertyType type, std::string value) = 0;
+                                      PropertyType type,
+                                   std::string_view value) = 0;
+
+        /**
+         * @brief Sets the value of a document property, adding it if the
+         * document doesn't have one yet.
+         *
+         * @param propID
+         * @param objID
+         * @param type any type but OBJECT is allowed.
+         * @param value
+         */
+        virtual void upsertStringLike(snowflake propID, snowflake objID,
+                                      PropertyType type,
+                                   std::string_view value) = 0;
+
+        /**
+         * @brief Same as `upsertStringLike` for INTEGER or BOOLEAN values.
+         *
+         * @param propID
+         * @param objID
+         * @param value booleans are stored as 0 or 1
+         */
+        virtual void upsertInteger(snowflake propID, snowflake objID,
+                                   int64_t value) = 0;
+
+        /**
+         * @brief Same as `upsertStringLike` for DOUBLE values.
+         *
+         * @param propID
+         * @param objID
+         * @param value
+         */
+        virtual void upsertDouble(snowflake propID, snowflake objID,
+                                  double value) = 0;
+
+        /**
+         * @brief Combines the INTEGER value of a document property with
+         * `value` in a single statement, or sets it to `value` if the
+         * document doesn't have one yet.
+         *
+         * @param propID
+         * @param objID
+         * @param op
+         * @param value
+         */
+        virtual void applyIntegerOperator(snowflake propID, snowflake objID,
+                                          UpdateOperator op, int64_t value) = 0;
+
+        /**
+         * @brief Same as `applyIntegerOperator` for DOUBLE values.
+         *
+         * @param propID
+         * @param objID
+         * @param op
+         * @param value
+         */
+        virtual void applyDoubleOperator(snowflake propID, snowflake objID,
+                                         UpdateOperator op, double value) = 0;
 
         /**
          * @brief Check if a document property has value.
@@ -78,12 +163,53 @@ namespace nldb {
                                                       snowflake objID) = 0;
 
         /**
-         * @brief Removes an object and all the values associated with it.
+         * @brief Removes an object and all the values associated with it,
+         * along with its sub-objects and their values.
          *
          * @param objID
          */
         virtual void removeObject(snowflake objID) = 0;
 
+        /**
+         * @brief Creates, if it doesn't exist yet, an index over the values
+         * of a property so filters and sorts on it don't need to scan
+         * every value of its type.
+         *
+         * @param propID
+         * @param type any type but OBJECT is allowed.
+         */
+        virtual void createIndex(snowflake propID, PropertyType type) = 0;
+
+        /**
+         * @brief Drops the index created with `createIndex`, if any.
+         *
+         * @param propID
+         * @param type
+         */
+        virtual void dropIndex(snowflake propID, PropertyType type) = 0;
+
+        /**
+         * @brief Finds the properties that have an index created with
+         * `createIndex`.
+         *
+         * @return std::vector<snowflake> their ids
+         */
+        virtual std::vector<snowflake> findIndexedProperties() = 0;
+
+        /**
+         * @brief Drops the index of the property, if any, remembering how to
+         * create it again with `restoreIndexes`. It's kept in the database,
+         * so it's restored even if the process dies before.
+         *
+         * @param propID
+         */
+        virtual void suspendIndex(snowflake propID) = 0;
+
+        /**
+         * @brief Creates again the indexes dropped by `suspendIndex`.
+         */
+        virtual void restoreIndexes() = 0;
+
         virtual ~IValuesDAO() = default;
     };
 }  // namespace nldb
\ No newline at end of file
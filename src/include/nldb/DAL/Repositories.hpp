@@ -1,6 +1,11 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <optional>
 
 #include "BufferData.hpp"
 #include "IRepositoryCollection.hpp"
@@ -8,6 +13,7 @@
 #include "IValuesDAO.hpp"
 
 namespace nldb {
+    struct SelectPlanCache;
 
     /**
      * @brief Ensures that all the repositories have the same DB connection.
@@ -18,14 +24,71 @@ namespace nldb {
             if (buffered) buffered->pushPendingData();
         }
 
+        void commitPendingData() {
+            if (buffered) buffered->commitPendingData();
+        }
+
+        void schedulePendingData() {
+            if (buffered) buffered->schedulePendingData();
+        }
+
+        void discardPendingData() {
+            if (buffered) buffered->discardPendingData();
+        }
+
+        /**
+         * @brief Flush the buffered data from a background thread, see
+         * BufferData::startBackgroundFlusher.
+         */
+        void startBackgroundFlusher(std::chrono::milliseconds maxLatency,
+                                    double fillRatio, double highWatermark) {
+            if (buffered) {
+                buffered->startBackgroundFlusher(maxLatency, fillRatio,
+                                                 highWatermark);
+            }
+        }
+
+        /**
+         * @brief Lets the calling thread add values and objects without
+         * holding `mtx`, see BufferData::Staging. Empty if they are not
+         * buffered, then they can only be added holding it.
+         */
+        std::optional<BufferData::Staging> stageValues() {
+            if (!buffered) return std::nullopt;
+
+            return std::optional<BufferData::Staging>(std::in_place,
+                                                      *buffered);
+        }
+
+        void clearCaches() {
+            repositoryCollection->clearCache();
+            repositoryProperty->clearCache();
+            catalogChanged();
+        }
+
+        /**
+         * @brief Counts the changes to the collections and properties, so
+         * what was built from them can tell when it's stale.
+         */
+        uint64_t getCatalogVersion() { return catalogVersion; }
+
+        // call it after adding a collection or a property
+        void catalogChanged() { catalogVersion++; }
+
         std::unique_ptr<IRepositoryCollection> repositoryCollection;
         std::unique_ptr<IRepositoryProperty> repositoryProperty;
         std::unique_ptr<IValuesDAO> valuesDAO;
 
-        std::mutex mtx;
+        // held by every operation, recursive so a Transaction can hold it
+        // across the operations it groups
+        std::recursive_mutex mtx;
+
+        // selects already built by the backend, null if they are not reused
+        std::shared_ptr<SelectPlanCache> selectPlans;
 
        protected:
         std::shared_ptr<BufferData> buffered;
+        std::atomic<uint64_t> catalogVersion {0};
 
        public:
         Repositories(std::unique_ptr<IRepositoryCollection> pRColl,
@@ -35,6 +98,22 @@ namespace nldb {
             : repositoryCollection(std::move(pRColl)),
               repositoryProperty(std::move(pRProp)),
               valuesDAO(std::move(pValDAO)),
-              buffered(std::move(pBuffered)) {}
+              buffered(std::move(pBuffered)) {
+            if (buffered) {
+                // the cache could have the collections and properties
+                // discarded
+                buffered->setOnDiscard([this]() { clearCaches(); });
+                buffered->setOperationLock(&mtx);
+            }
+        }
+
+        ~Repositories() {
+            if (buffered) {
+                // it uses our mutex
+                buffered->stopBackgroundFlusher();
+                buffered->setOnDiscard(nullptr);
+                buffered->setOperationLock(nullptr);
+            }
+        }
     };
 }  // namespace nldb
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+
+namespace nldb {
+    /**
+     * @brief Operators that combine the stored value of a numeric property
+     * with another number. The database applies each one in a single
+     * statement, so there is no need to read the value first. If the object
+     * doesn't have the property yet, it's set to the operand.
+     */
+    enum UpdateOperator {
+        INCREMENT,  // $inc, adds the operand
+        MINIMUM,    // $min, keeps the smallest
+        MAXIMUM     // $max, keeps the largest
+    };
+}  // namespace nldb
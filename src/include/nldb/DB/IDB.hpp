@@ -51,12 +51,22 @@ namespace nldb {
          */
         virtual void rollback() = 0;
 
+        /**
+         * @brief Check if there is an open transaction in this connection.
+         *
+         * @return true
+         * @return false
+         */
+        virtual bool isInTransaction() = 0;
+
         /**
          * @brief Executes a query immediately (if no transaction was started).
          * Should support multiple inserts.
          *
          * @param query
-         * @param params
+         * @param params values to bind in the query, same as in
+         * `executeReader`. Only values can be bound, not identifiers like
+         * table names.
          * @return void
          */
         virtual void execute(const std::string& query,
@@ -23,6 +23,12 @@ namespace nldb {
             : std::runtime_error("Document not found " + extra) {}
     };
 
+    class InvalidUpdate : public std::runtime_error {
+       public:
+        InvalidUpdate(str extra = "")
+            : std::runtime_error("Invalid update " + extra) {}
+    };
+
     class WrongPropertyType : public std::runtime_error {
        public:
         WrongPropertyType(str pName = "", str pExpected = "", str pActual = "")
@@ -1,23 +1,81 @@
 #pragma once
+#include <chrono>
+#include <functional>
+
 #include "nldb/nldb_json.hpp"
 
 namespace nldb {
+    struct LoadStats {
+        long long documents {0};
+        std::chrono::milliseconds elapsed {0};
+
+        double documentsPerSecond() const {
+            return elapsed.count() > 0 ? documents * 1000.0 / elapsed.count()
+                                       : (double)documents;
+        }
+    };
+
+    struct SelectPage {
+        json documents = json::array();
+
+        // pass it to `after` to get the next page, empty on the last one
+        std::string next;
+
+        // pass it to `before` to get the previous page, empty on the first
+        std::string previous;
+    };
 
     // IQueryRunner -> QueryContext -> queryRunner:IQueryRunner -> IQueryRunner
     // -> ...
     struct QueryPlannerContextUpdate;
+    struct QueryPlannerContextUpdateWhere;
     struct QueryPlannerContextInsert;
+    struct QueryPlannerContextInsertRaw;
     struct QueryPlannerContextRemove;
+    struct QueryPlannerContextRemoveWhere;
+    struct QueryPlannerContextCountWhere;
     struct QueryPlannerContextSelect;
+    struct QueryPlannerContextGet;
+    struct QueryPlannerContextIndex;
+    struct QueryPlannerContextLoad;
 
     class IQueryRunner {
        public:
         virtual json select(QueryPlannerContextSelect&& data) = 0;
+
+        // calls onDocument with each document as it's read, until it returns
+        // false, and returns how many documents were read
+        virtual long long stream(
+            QueryPlannerContextSelect&& data,
+            const std::function<bool(json&)>& onDocument) = 0;
+
+        // reads a page of documents sorted by their sort keys and then by
+        // their id, starting after or before the keyset of the context
+        virtual SelectPage selectPage(QueryPlannerContextSelect&& data) = 0;
+
+        // reads the documents with the ids given, in that order, skipping
+        // the ones not found
+        virtual json get(QueryPlannerContextGet&& data) = 0;
+
         virtual void update(QueryPlannerContextUpdate&& data) = 0;
+
+        // updates the documents matched and returns how many they were
+        virtual int update(QueryPlannerContextUpdateWhere&& data) = 0;
         virtual std::vector<std::string> insert(
             QueryPlannerContextInsert&& data) = 0;
+        virtual std::vector<std::string> insertRaw(
+            QueryPlannerContextInsertRaw&& data) = 0;
         virtual void remove(QueryPlannerContextRemove&& data) = 0;
 
+        // removes the documents matched and returns how many they were
+        virtual int remove(QueryPlannerContextRemoveWhere&& data) = 0;
+
+        // counts the documents matched, or up to one if `onlyExists` is set
+        virtual long long count(QueryPlannerContextCountWhere&& data) = 0;
+        virtual void createIndex(QueryPlannerContextIndex&& data) = 0;
+        virtual void dropIndex(QueryPlannerContextIndex&& data) = 0;
+        virtual LoadStats load(QueryPlannerContextLoad&& data) = 0;
+
         virtual ~IQueryRunner() = default;
     };
 }  // namespace nldb
\ No newline at end of file
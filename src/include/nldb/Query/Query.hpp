@@ -6,6 +6,7 @@
 #include "nldb/DB/IDB.hpp"
 #include "nldb/Implementation.hpp"
 #include "nldb/Query/QueryPlanner.hpp"
+#include "nldb/Query/Transaction.hpp"
 
 namespace nldb {
 
@@ -16,9 +17,32 @@ namespace nldb {
         uint MediumBufferSize = (int)(50.0 * 1000.0) /* 50 KB*/;
         uint LargeBufferSize = (int)(1 * 1e6) /* 1 MB */;
 
+        // each flush of the buffers is written in a transaction, this sets how
+        // many flushes share the same one. Fewer commits are faster but the
+        // data of the uncommitted flushes can be lost on a crash.
+        uint FlushesPerCommit = 1;
+        // the flushes sharing a transaction are committed once it's been open
+        // for this long, checked on each flush
+        uint CommitMaxDelayMs = 1000;
+
+        // flush the buffers from a background thread, so inserts return as
+        // soon as their data is buffered. Selects still see the buffered data.
+        // If a flush fails, the next operation throws its error.
+        bool BackgroundFlush = false;
+        // the buffered data waits at most this time to be flushed
+        uint FlushMaxLatencyMs = 100;
+        // flush once a buffer is filled up to this ratio
+        double FlushFillRatio = 0.5;
+        // from this ratio on, the thread adding the data flushes it itself
+        double FlushHighWatermark = 0.9;
+
         // use cached repositories?
         bool PreferCache = true;
 
+        // number of selects kept already built, so running one with the same
+        // shape as before only binds its values. 0 disables it.
+        uint SelectPlanCacheSize = 128;
+
         // reuse cached repositories
         std::shared_ptr<Repositories> cachedRepositories = nullptr;
 
@@ -79,6 +103,29 @@ namespace nldb {
          */
         Collection collection(const char* name) { return Collection(name); }
 
+        /**
+         * @brief Starts a transaction, the operations until it's committed or
+         * rolled back are part of it. See Transaction.
+         */
+        Transaction transaction() {
+            return Transaction(connection, repositories);
+        }
+
+        /**
+         * @brief Runs `fn` in a transaction. It's committed when `fn`
+         * returns, unless `fn` rolled it back, and rolled back if `fn` throws.
+         *
+         * @param fn callable taking the Transaction&
+         */
+        template <typename F>
+        void transaction(F&& fn) {
+            Transaction tx(connection, repositories);
+
+            fn(tx);
+
+            if (tx.isActive()) tx.commit();
+        }
+
         std::shared_ptr<Repositories> getRepositories() { return repositories; }
 
         std::vector<Collection> getCollections() {
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <istream>
 #include <list>
 #include <optional>
+#include <string_view>
 #include <variant>
 #include <vector>
 
@@ -33,6 +35,15 @@ namespace nldb {
         int elementsPerPage {10};
     };
 
+    struct QueryKeyset {
+        // sort keys followed by the id of the document to read after or
+        // before, empty to read from the start
+        json keys;
+
+        // read the documents before instead of after it
+        bool before {false};
+    };
+
     struct RenamedProperty {
         Property prop;
         const std::string alias;
@@ -45,6 +56,7 @@ namespace nldb {
         std::list<SelectableProperty> select_value;
         std::optional<PropertyExpression> where_value;
         std::optional<QueryPagination> pagination_value;
+        std::optional<QueryKeyset> keyset_value;
         std::vector<Property> groupBy_value;
         std::vector<SortedProperty> sortBy_value;
         std::vector<Property> suppress_value;
@@ -59,6 +71,13 @@ namespace nldb {
         snowflake documentID;
     };
 
+    struct QueryPlannerContextGet : public QueryPlannerContext {
+        QueryPlannerContextGet(QueryPlannerContext&& ctx)
+            : QueryPlannerContext(std::move(ctx)) {}
+
+        std::vector<snowflake> documentIDs;
+    };
+
     struct QueryPlannerContextUpdate : public QueryPlannerContext {
         QueryPlannerContextUpdate(QueryPlannerContext&& ctx)
             : QueryPlannerContext(std::move(ctx)) {}
@@ -67,10 +86,60 @@ namespace nldb {
         json object;
     };
 
+    struct QueryPlannerContextWhere : public QueryPlannerContext {
+        QueryPlannerContextWhere(QueryPlannerContext&& ctx)
+            : QueryPlannerContext(std::move(ctx)) {}
+
+        std::optional<PropertyExpression> where_value;
+    };
+
+    struct QueryPlannerContextUpdateWhere : public QueryPlannerContextWhere {
+        QueryPlannerContextUpdateWhere(QueryPlannerContextWhere&& ctx)
+            : QueryPlannerContextWhere(std::move(ctx)) {}
+
+        json object;
+    };
+
+    struct QueryPlannerContextRemoveWhere : public QueryPlannerContextWhere {
+        QueryPlannerContextRemoveWhere(QueryPlannerContextWhere&& ctx)
+            : QueryPlannerContextWhere(std::move(ctx)) {}
+    };
+
+    struct QueryPlannerContextCountWhere : public QueryPlannerContextWhere {
+        QueryPlannerContextCountWhere(QueryPlannerContextWhere&& ctx)
+            : QueryPlannerContextWhere(std::move(ctx)) {}
+
+        // stop at the first document found
+        bool onlyExists {false};
+    };
+
     struct QueryPlannerContextInsert : public QueryPlannerContext {
         QueryPlannerContextInsert(QueryPlannerContext&& ctx)
             : QueryPlannerContext(std::move(ctx)) {}
 
         json documents;  // json can be an array of object
     };
+
+    struct QueryPlannerContextInsertRaw : public QueryPlannerContext {
+        QueryPlannerContextInsertRaw(QueryPlannerContext&& ctx)
+            : QueryPlannerContext(std::move(ctx)) {}
+
+        std::string_view documents;  // a json object or array of objects
+    };
+
+    struct QueryPlannerContextLoad : public QueryPlannerContext {
+        QueryPlannerContextLoad(QueryPlannerContext&& ctx, std::istream& pInput)
+            : QueryPlannerContext(std::move(ctx)), input(pInput) {}
+
+        std::istream& input;
+        int batchSize {1000};
+    };
+
+    struct QueryPlannerContextIndex : public QueryPlannerContext {
+        QueryPlannerContextIndex(QueryPlannerContext&& ctx,
+                                 const Property& pProperty)
+            : QueryPlannerContext(std::move(ctx)), property(pProperty) {}
+
+        Property property;
+    };
 }  // namespace nldb
\ No newline at end of file
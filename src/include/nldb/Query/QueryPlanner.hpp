@@ -1,9 +1,12 @@
 #pragma once
 
+#include <istream>
 #include <optional>
+#include <string_view>
 #include <type_traits>
 
 #include "QueryPlannerSelect.hpp"
+#include "QueryPlannerWhere.hpp"
 #include "nldb/Object.hpp"
 #include "nldb/Property/Property.hpp"
 #include "nldb/nldb_json.hpp"
@@ -37,6 +40,30 @@ namespace nldb {
             return QueryPlannerSelect(std::move(ctx));
         }
 
+        /**
+         * @brief Filters the documents to update, remove or count by some
+         * condition instead of by their id, see QueryPlannerWhere.
+         *
+         * e.g. to mark all the cars from 2003 as legacy
+         *  query.from("cars").where(cars["year"] == 2003)
+         *      .update({{"legacy", true}});
+         *
+         * @return QueryPlannerWhere
+         */
+        QueryPlannerWhere where(const PropertyExpression& expr);
+
+        /**
+         * @brief Counts all the documents of the collection.
+         *
+         * @return long long
+         */
+        long long count();
+
+        /**
+         * @brief Checks if the collection has any document.
+         */
+        bool exists();
+
         /**
          * @brief Inserts the documents and returns their ids.
          * The id of the first document will be the first element of the
@@ -51,6 +78,67 @@ namespace nldb {
          */
         std::vector<std::string> insert(const json& object);
 
+        /**
+         * @brief Same as `insert` but taking the json text, e.g. as received
+         * from a socket. The documents are inserted while the text is
+         * parsed, without building a json object first.
+         *
+         * The `_id` of a document, if any, must come before its
+         * sub-documents. If the text is not valid, none of its documents are
+         * inserted.
+         *
+         * @param documents a json object or an array of them
+         * @return std::vector<std::string> ids of the documents
+         */
+        std::vector<std::string> insertRaw(std::string_view documents);
+
+        /**
+         * @brief Inserts the documents read from a json array or from
+         * newline delimited json, one document per line.
+         *
+         * The input is parsed as it's read and the documents are inserted in
+         * batches, so memory use doesn't depend on the input size. The
+         * indexes created with `createIndex` are dropped during the load and
+         * created again at the end, or when the database is opened again if
+         * the load didn't end.
+         *
+         * @param input
+         * @param batchSize documents inserted at once
+         * @return LoadStats how many documents were loaded and how fast
+         */
+        LoadStats load(std::istream& input, int batchSize = 1000);
+
+        /**
+         * @brief Same as `load`, reading the file at `path`.
+         */
+        LoadStats loadFile(const std::string& path, int batchSize = 1000);
+
+        /**
+         * @brief Gets a document by its id, the same one
+         * `select().where(coll["_id"] == id)` would return but reading its
+         * values directly instead of joining each property.
+         *
+         * @param docId
+         * @return std::optional<json> the document, if it exists
+         */
+        std::optional<json> get(snowflake docId);
+
+        /**
+         * @brief overload of the function above
+         *
+         * @param docId
+         */
+        std::optional<json> get(const std::string& docId);
+
+        /**
+         * @brief Gets many documents by their id at once, see `get`.
+         *
+         * @param docIds
+         * @return json array with the documents found, in the order of their
+         * ids
+         */
+        json getMany(const std::vector<std::string>& docIds);
+
         /**
          * @brief Update a document.
          * You can update every property and sub-property of the document.
@@ -67,6 +155,11 @@ namespace nldb {
          *  In this case a new property (and all its sub-properties if it's an
          *  object) for the document collection is added
          *
+         * Numeric operators
+         * -----------------
+         *  A number can be combined with the stored one in a single
+         *  statement, e.g. {{"views", {{"$inc", 1}}}}, see `UpdateOperator`.
+         *
          * @param docId
          * @param newValue
          */
@@ -94,6 +187,29 @@ namespace nldb {
          */
         void remove(const std::string& docId);
 
+        /**
+         * @brief Indexes the values of a property, speeding up the queries
+         * that filter or sort by it. The index is stored in the database, so
+         * it only needs to be created once.
+         *
+         * e.g. to index the year of the cars
+         *  query.from("cars").createIndex(cars["year"]);
+         *
+         * Only properties with a value can be indexed, to index a
+         * sub-document index its properties instead, e.g.
+         * cars["technical"]["weight"].
+         *
+         * @param property
+         */
+        void createIndex(const Property& property);
+
+        /**
+         * @brief Drops an index created with `createIndex`.
+         *
+         * @param property
+         */
+        void dropIndex(const Property& property);
+
        protected:
         QueryPlannerContext context;
     };
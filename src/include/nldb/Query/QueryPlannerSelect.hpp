@@ -1,6 +1,7 @@
 #pragma once
 
 #include <concepts>
+#include <functional>
 #include <type_traits>
 
 #include "nldb/Property/Property.hpp"
@@ -40,6 +41,39 @@ namespace nldb {
 
         QueryPlannerSelect& limit(int elementsPerPage);
 
+        /**
+         * @brief Get the elements that follow the ones of a previous page,
+         * using the `next` token that came with it. Unlike `page`, the
+         * elements before it are not read again, so all the pages cost the
+         * same. The elements are also sorted by their id after the `sortBy`
+         * properties, so each one has a single place. `page` is ignored.
+         *
+         * @param token `SelectPage::next`
+         * @return QueryPlannerSelect&
+         */
+        QueryPlannerSelect& after(const std::string& token);
+
+        /**
+         * @brief Same as `after` but starting after the document with this id
+         * and values of the `sortBy` properties.
+         *
+         * @param lastSortKeys an array with a value for each `sortBy`
+         * property, or the value if there is only one
+         * @param lastId
+         * @return QueryPlannerSelect&
+         */
+        QueryPlannerSelect& after(const json& lastSortKeys,
+                                  const std::string& lastId);
+
+        /**
+         * @brief Same as `after` but getting the elements that precede the
+         * ones of a page.
+         *
+         * @param token `SelectPage::previous`
+         * @return QueryPlannerSelect&
+         */
+        QueryPlannerSelect& before(const std::string& token);
+
         /**
          * @brief This will make each document inside the collection document
          * also show its own _id.
@@ -98,6 +132,27 @@ namespace nldb {
 
         json execute();
 
+        /**
+         * @brief Same as `execute` but without keeping all the documents in
+         * memory, each one is passed to `onDocument` as soon as it's read.
+         * Return false from it to stop reading.
+         *
+         * The database is locked while the documents are read, so don't
+         * change it from `onDocument`.
+         *
+         * @param onDocument
+         * @return long long number of documents read
+         */
+        long long stream(const std::function<bool(json&)>& onDocument);
+
+        /**
+         * @brief Same as `execute` but also returns the tokens to get the
+         * page after and before this one, see `after`.
+         *
+         * @return SelectPage
+         */
+        SelectPage executePage();
+
        protected:
         QueryPlannerContextSelect context;
     };
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "nldb/Property/PropertyExpression.hpp"
+#include "nldb/Query/QueryContext.hpp"
+#include "nldb/nldb_json.hpp"
+
+namespace nldb {
+    /**
+     * @brief Operations over all the documents that satisfy some condition,
+     * run as a few statements over the whole set instead of one operation
+     * per document.
+     *
+     * The properties used in the conditions must exist, else
+     * PropertyNotFound is thrown instead of ignoring the condition.
+     */
+    class QueryPlannerWhere {
+       public:
+        QueryPlannerWhere(QueryPlannerContextWhere&& context);
+
+       public:
+        /**
+         * @brief filters elements by some condition.
+         * Multiple calls to this functions results in an "AND" between the
+         * conditions.
+         *
+         * @return QueryPlannerWhere&
+         */
+        QueryPlannerWhere& where(const PropertyExpression&);
+
+        /**
+         * @brief Updates the documents, same as updating each one by its id.
+         * The documents are matched before changing any of them, so the new
+         * values don't change which ones are updated. The update operators,
+         * e.g. {{"views", {{"$inc", 1}}}}, take a statement for all of them.
+         *
+         * @param newValue
+         * @return int number of documents updated
+         */
+        int update(const json& newValue);
+
+        /**
+         * @brief Removes the documents, along with their sub-documents.
+         *
+         * @return int number of documents removed
+         */
+        int remove();
+
+        /**
+         * @brief Counts the documents, without reading them.
+         *
+         * @return long long number of documents
+         */
+        long long count();
+
+        /**
+         * @brief Checks if there is any document, stopping at the first one.
+         */
+        bool exists();
+
+       protected:
+        QueryPlannerContextWhere context;
+    };
+}  // namespace nldb
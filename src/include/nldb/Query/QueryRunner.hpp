@@ -8,6 +8,7 @@
 #include "nldb/Property/Property.hpp"
 #include "nldb/Query/IQueryRunner.hpp"
 #include "nldb/Query/QueryContext.hpp"
+#include "nldb/Query/SchemaMemo.hpp"
 #include "nldb/Utils/Variant.hpp"
 
 namespace nldb {
@@ -19,6 +20,8 @@ namespace nldb {
      * Can be optimized by working in a more handcrafted implementation.
      */
     class QueryRunner : public IQueryRunner {
+        friend class DocumentSaxInserter;
+
        public:
         QueryRunner(IDB* connection, std::shared_ptr<Repositories> repos);
 
@@ -29,22 +32,25 @@ namespace nldb {
         // inserts the documents and returns their ids
         virtual std::vector<std::string> insert(
             QueryPlannerContextInsert&& data) override;
+
+        // same as insert, but parsing the documents while inserting them
+        virtual std::vector<std::string> insertRaw(
+            QueryPlannerContextInsertRaw&& data) override;
         virtual void remove(QueryPlannerContextRemove&& data) override;
+        virtual void createIndex(QueryPlannerContextIndex&& data) override;
+        virtual void dropIndex(QueryPlannerContextIndex&& data) override;
+        virtual LoadStats load(QueryPlannerContextLoad&& data) override;
 
        protected:  // helpers runners
         /**
          * @brief inserts a new document and returns its id.
          * @param doc object to insert
-         * @param collName target collection
-         * @param repos repositories/data access objects
+         * @param coll target collection, from the memo of the batch
          * @param parentObjID parent object
-         * @param rootPropID the parent property id for the new collection (if
-         * missing).
          */
         virtual snowflake insertDocumentRecursive(
-            json& doc, const std::string& collName,
-            std::optional<snowflake> parentObjID = std::nullopt,
-            std::optional<snowflake> rootPropID = std::nullopt);
+            json& doc, SchemaMemo::CollectionEntry& coll,
+            std::optional<snowflake> parentObjID = std::nullopt);
 
         /**
          * @brief updates a document that can contain more documents (objects)
@@ -57,6 +63,78 @@ namespace nldb {
                                              const Collection& collection,
                                              json& object);
 
+        /**
+         * @brief finds the property of the collection, checking that a value
+         * of `type` can be stored in it, or adds it if missing.
+         * @param type type of the value, set to the type to store it as
+         * @return snowflake property id
+         */
+        snowflake findOrAddProperty(snowflake collID,
+                                    const std::string& propertyName,
+                                    PropertyType& type);
+
+        /**
+         * @brief same as findOrAddProperty for the operand of an update
+         * operator, which must be a number.
+         * @param type set to the type to store the operand as
+         */
+        snowflake findOrAddOperatorProperty(snowflake collID,
+                                            const std::string& propertyName,
+                                            const json& operand,
+                                            PropertyType& type);
+
+        /**
+         * @brief applies the update operators of a property of an object,
+         * e.g. {"$inc": 1}, see `UpdateOperator`.
+         */
+        void applyUpdateOperators(snowflake objID,
+                                  const Collection& collection,
+                                  const std::string& propertyName,
+                                  json& operators);
+
+        /**
+         * @brief gets the root collection from the memo, finding or adding it
+         * the first time.
+         *
+         * The memo functions only take the operations lock when they need to
+         * find or add something, so the documents of an insert can be staged
+         * without holding it.
+         */
+        SchemaMemo::CollectionEntry& memoCollection(
+            SchemaMemo& memo, const std::string& collName);
+
+        /**
+         * @brief same as findOrAddProperty, but only the first time the
+         * property is seen in the batch.
+         */
+        SchemaMemo::PropertyEntry& memoProperty(
+            SchemaMemo::CollectionEntry& coll, const std::string& propertyName,
+            PropertyType& type);
+
+        /**
+         * @brief gets the collection of the documents of an OBJECT property,
+         * finding or adding it the first time.
+         */
+        SchemaMemo::CollectionEntry& memoSubCollection(
+            SchemaMemo::CollectionEntry& coll, const std::string& propertyName,
+            SchemaMemo::PropertyEntry& prop);
+
+        /**
+         * @brief adds a value of any type but OBJECT, numbers and booleans
+         * are added as they are instead of as strings.
+         * @param type type to store the value as
+         */
+        void addValue(snowflake propID, snowflake objID, PropertyType type,
+                      json& value);
+
+        /**
+         * @brief same as `addValue` but replaces the value the object already
+         * has for the property, if any.
+         * @param type type to store the value as
+         */
+        void upsertValue(snowflake propID, snowflake objID, PropertyType type,
+                         json& value);
+
        protected:  // helpers data
         virtual snowflake getLastCollectionIdFromExpression(
             const std::string& expr);
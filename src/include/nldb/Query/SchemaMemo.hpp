@@ -0,0 +1,49 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "nldb/Property/Property.hpp"
+#include "nldb/typedef.hpp"
+
+namespace nldb {
+    /**
+     * @brief Collections and properties already resolved while inserting a
+     * batch of documents.
+     *
+     * It's a trie: a collection maps its property names to their id and
+     * type, and an object property to its sub-collection. Documents with the
+     * same shape follow the same path, without going through the property and
+     * collection repositories again.
+     *
+     * Only valid while the repositories lock is held, since nothing else can
+     * change the schema meanwhile.
+     */
+    struct SchemaMemo {
+        struct CollectionEntry;
+
+        struct PropertyEntry {
+            snowflake id {};
+
+            // type the values are stored as
+            PropertyType type {};
+
+            // collection of the documents of an OBJECT property
+            std::unique_ptr<CollectionEntry> subCollection {};
+        };
+
+        struct CollectionEntry {
+            std::string name {};
+            snowflake id {};
+
+            // property that owns this collection
+            snowflake rootPropID {};
+
+            std::unordered_map<std::string, PropertyEntry> properties {};
+        };
+
+        // root collections by name
+        std::unordered_map<std::string, CollectionEntry> collections;
+    };
+}  // namespace nldb
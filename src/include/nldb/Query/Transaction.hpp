@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+
+#include "nldb/DAL/Repositories.hpp"
+#include "nldb/DB/IDB.hpp"
+
+namespace nldb {
+    /**
+     * @brief Groups many operations in a single database transaction, so
+     * they are committed or rolled back together.
+     *
+     * The operations lock is held from its construction until it's
+     * committed or rolled back, the operations of other threads wait for it.
+     * The data buffered before it started is written apart, and the data
+     * buffered while it's open is written in it.
+     * If it's destroyed while still open it's rolled back.
+     *
+     * @example
+     * {
+     *     Transaction tx = query.transaction();
+     *     query.from("users").update(id, {{"age", 30}});
+     *     query.from("logs").insert({{"user", id}});
+     *     tx.commit();
+     * }
+     */
+    class Transaction {
+       public:
+        Transaction(IDB* connection, std::shared_ptr<Repositories> repos);
+
+        Transaction(const Transaction&) = delete;
+        Transaction& operator=(const Transaction&) = delete;
+
+        /**
+         * @brief Writes the buffered data and commits. If either fails the
+         * transaction is rolled back and the exception rethrown.
+         */
+        void commit();
+
+        /**
+         * @brief Discards everything done in the transaction, including the
+         * data that is still buffered.
+         */
+        void rollback();
+
+        /**
+         * @brief Was it not committed nor rolled back yet?
+         */
+        bool isActive() const;
+
+        ~Transaction();
+
+       private:
+        void finish();
+
+       private:
+        IDB* connection;
+        std::shared_ptr<Repositories> repos;
+        std::unique_lock<std::recursive_mutex> lock;
+        bool active {false};
+    };
+}  // namespace nldb
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include "nldb/DAL/UpdateOperator.hpp"
+#include "nldb/nldb_json.hpp"
+
+namespace nldb {
+    /**
+     * @brief finds the operator with that key, e.g. "$inc".
+     */
+    std::optional<UpdateOperator> FindUpdateOperator(const std::string& key);
+
+    /**
+     * @brief checks if a value is an object of update operators instead of a
+     * sub-document. Throws InvalidUpdate if it mixes both.
+     *
+     * In an update they are an object with the operators as keys, e.g.
+     * {{"views", {{"$inc", 1}}}} or {{"price", {{"$min", 10}}}}. Operators on
+     * the same property are applied sorted by their key.
+     */
+    bool IsUpdateOperation(const json& value);
+}  // namespace nldb
@@ -15,6 +15,7 @@
 #include "backends/sqlite3/DAL/ValuesDAO.hpp"
 #include "backends/sqlite3/DB/DB.hpp"
 #include "backends/sqlite3/Query/QueryRunner.hpp"
+#include "backends/sqlite3/Query/SelectPlan.hpp"
 #include "nldb/DAL/Buffer/BufferedRepositoryCollection.hpp"
 #include "nldb/DAL/Buffer/BufferedRepositoryProperty.hpp"
 #include "nldb/DAL/Buffer/BufferedValuesDAO.hpp"
@@ -37,11 +38,14 @@ namespace nldb {
             IDB* conn, const QueryConfiguration& cfg) {
             //
             std::shared_ptr<BufferData> bufferData =
-                cfg.PreferBuffer
-                    ? std::make_shared<BufferDataSQ3>(conn, cfg.SmallBufferSize,
-                                                      cfg.MediumBufferSize,
-                                                      cfg.LargeBufferSize)
-                    : nullptr;
+                cfg.PreferBuffer ? std::make_shared<BufferDataSQ3>(
+                                       static_cast<DBSL3*>(conn),
+                                       cfg.SmallBufferSize,
+                                       cfg.MediumBufferSize,
+                                       cfg.LargeBufferSize,
+                                       cfg.FlushesPerCommit,
+                                       cfg.CommitMaxDelayMs)
+                                 : nullptr;
 
             // build repositories
             std::unique_ptr<IRepositoryCollection> repoColl =
@@ -72,9 +76,22 @@ namespace nldb {
                     std::move(repoProp));
             }
 
-            return std::make_shared<Repositories>(
+            auto repositories = std::make_shared<Repositories>(
                 std::move(repoColl), std::move(repoProp), std::move(valuesDao),
                 bufferData);
+
+            if (cfg.SelectPlanCacheSize > 0) {
+                repositories->selectPlans =
+                    std::make_shared<SelectPlanCache>(cfg.SelectPlanCacheSize);
+            }
+
+            if (cfg.PreferBuffer && cfg.BackgroundFlush) {
+                repositories->startBackgroundFlusher(
+                    std::chrono::milliseconds(cfg.FlushMaxLatencyMs),
+                    cfg.FlushFillRatio, cfg.FlushHighWatermark);
+            }
+
+            return repositories;
         }
     };
 
@@ -1,29 +1,44 @@
 #pragma once
 
-#include <time.h>
-
-#include <array>
-#include <bitset>
+#include <atomic>
 #include <chrono>
-#include <cmath>
 #include <cstdint>
-#include <iomanip>  // std::setw
-#include <iostream>
-#include <mutex>
-#include <thread>
 
 #include "nldb/typedef.hpp"
 
 namespace nldb {
+    /**
+     * @brief Generates unique ids: a millisecond timestamp followed by a
+     * sequence number.
+     *
+     * Each thread reserves a block of ids from a shared atomic counter and
+     * hands them out without any synchronization until the block is used.
+     * The shared counter never falls behind the clock, so ids keep growing
+     * with time and don't collide with the ones given in a previous run.
+     */
     class SnowflakeGenerator {
        public:
-        static snowflake generate(uint16_t threadID);
+        static snowflake generate();
+
+       public:
+        // bits of the id below the timestamp
+        static constexpr int sequenceBits = 21;
+
+        // ids a thread reserves at once
+        static constexpr snowflake blockSize = 1 << 12;
 
        private:
+        // reserves the next block of ids and returns its first id
+        static snowflake reserveBlock();
+
         static inline snowflake getCurrentTimestampMs() {
             return std::chrono::duration_cast<std::chrono::milliseconds>(
                        std::chrono::system_clock::now().time_since_epoch())
                 .count();
         }
+
+       private:
+        // first id not reserved yet
+        static std::atomic<snowflake> nextFree;
     };
-}  // namespace nldb
\ No newline at end of file
+}  // namespace nldb
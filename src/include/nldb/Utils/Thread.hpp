@@ -1,7 +0,0 @@
-#pragma once
-
-#include <cstdint>
-
-namespace nldb {
-    uint16_t getThreadID();
-}
\ No newline at end of file
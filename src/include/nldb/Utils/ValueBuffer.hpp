@@ -2,7 +2,11 @@
 
 #include <algorithm>
 #include <array>
+#include <cstring>
+#include <memory>
 #include <mutex>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
 #include "nldb/Property/Property.hpp"
@@ -15,6 +19,93 @@ namespace nldb {
         bool try_lock() { return true; }
     };
 
+    /**
+     * @brief Holds copies of strings until it's reset, all at once.
+     *
+     * Strings are copied one after the other into chunks of memory, so
+     * storing one is usually just a bump of the used bytes and a copy. A new
+     * chunk is only allocated when the current one is full, and on reset they
+     * are merged into one so the next cycle doesn't need to allocate.
+     *
+     * It has a single writer at a time, e.g. DoubleBuffer stores into it
+     * under its lock.
+     */
+    class StringArena {
+       public:
+        /**
+         * @param chunkSize bytes of the first chunk, allocated on the first
+         * string stored.
+         */
+        StringArena(size_t chunkSize)
+            : chunkSize(std::max<size_t>(chunkSize, 1)) {}
+
+        /**
+         * @brief Copies a string into the arena.
+         *
+         * @return std::string_view the copy, valid until the next reset
+         */
+        std::string_view Store(std::string_view str) {
+            if (str.empty()) return {};
+
+            if (chunks.empty() ||
+                chunks.back()->used + str.size() > chunks.back()->capacity) {
+                addChunk(std::max(chunkSize, str.size()));
+            }
+
+            Chunk& chunk = *chunks.back();
+
+            char* copy = chunk.data.get() + chunk.used;
+            std::memcpy(copy, str.data(), str.size());
+            chunk.used += str.size();
+
+            return std::string_view(copy, str.size());
+        }
+
+        /**
+         * @brief Discards all the strings.
+         */
+        void Reset() {
+            if (chunks.size() > 1) {
+                size_t total = 0;
+                for (auto& chunk : chunks) total += chunk->capacity;
+
+                chunks.clear();
+                addChunk(total);
+            } else if (!chunks.empty()) {
+                chunks[0]->used = 0;
+            }
+        }
+
+        /**
+         * @brief Bytes allocated, used or not.
+         */
+        size_t Capacity() {
+            size_t total = 0;
+            for (auto& chunk : chunks) total += chunk->capacity;
+
+            return total;
+        }
+
+       private:
+        struct Chunk {
+            Chunk(size_t pCapacity)
+                : data(std::make_unique<char[]>(pCapacity)),
+                  capacity(pCapacity) {}
+
+            std::unique_ptr<char[]> data;
+            size_t capacity;
+            size_t used {0};
+        };
+
+        void addChunk(size_t capacity) {
+            chunks.push_back(std::make_unique<Chunk>(capacity));
+        }
+
+       private:
+        size_t chunkSize;
+        std::vector<std::unique_ptr<Chunk>> chunks;
+    };
+
     template <typename T, class Lock = NullLock>
     class Buffer {
        public:
@@ -87,4 +178,166 @@ namespace nldb {
         int elementCount {0};
         Lock lock;
     };
+
+    /**
+     * @brief Buffer with two halves. Elements are added to the active half
+     * while the frozen one is consumed, freezing swaps them without copying.
+     *
+     * Each half has a StringArena that holds the strings its elements point
+     * to, so they don't need to own them. See `Add`.
+     *
+     * Only one consumer should call the *Frozen methods and `Freeze`.
+     */
+    template <typename T, class Lock = NullLock>
+    class DoubleBuffer {
+       public:
+        /**
+         * @param bufferSize max size of each half
+         * @param arenaSize initial bytes of the arena of each half
+         */
+        DoubleBuffer(int bufferSize, size_t arenaSize = 0)
+            : bufferSize(bufferSize),
+              arenas {StringArena(arenaSize), StringArena(arenaSize)} {
+            halves[0].resize(bufferSize);
+            halves[1].resize(bufferSize);
+        }
+
+        /**
+         * @brief add a new element to the active half
+         *
+         * @param data new element
+         * @param payload member of the element, if any, pointing to a string
+         * to copy into the arena. The element will point to the copy, which
+         * lives until its half is released.
+         * @return true if the element was added
+         * @return false if the active half is full
+         */
+        template <typename Payload = std::nullptr_t>
+        bool Add(T data, Payload payload = nullptr) {
+            Guard l(lock);
+
+            if (activeCount + 1 > this->bufferSize) return false;
+
+            if constexpr (!std::is_null_pointer_v<Payload>) {
+                data.*payload = arenas[active].Store(data.*payload);
+            }
+
+            halves[active][activeCount++] = std::move(data);
+
+            return true;
+        }
+
+        /**
+         * @brief adds the elements of [first, last) to the active half, as
+         * many as fit, taking the lock only once.
+         *
+         * @param payload see `Add`
+         * @return It the first element that didn't fit, `last` if all of
+         * them were added
+         */
+        template <typename It, typename Payload = std::nullptr_t>
+        It AddMany(It first, It last, Payload payload = nullptr) {
+            Guard l(lock);
+
+            for (; first != last && activeCount < bufferSize; ++first) {
+                T data = *first;
+
+                if constexpr (!std::is_null_pointer_v<Payload>) {
+                    data.*payload = arenas[active].Store(data.*payload);
+                }
+
+                halves[active][activeCount++] = std::move(data);
+            }
+
+            return first;
+        }
+
+        /**
+         * @brief Checks if any element of the active half matches.
+         *
+         * @param pred e.g. [](const T& t) { return t.id == 1; }
+         */
+        template <typename F>
+        bool AnyActive(const F& pred) {
+            Guard l(lock);
+
+            auto& current = halves[active];
+            return std::any_of(current.begin(), current.begin() + activeCount,
+                               pred);
+        }
+
+        /**
+         * @brief Freezes the active half and starts filling the other one.
+         * The previously frozen elements must have been released.
+         *
+         * @return int number of frozen elements
+         */
+        int Freeze() {
+            Guard l(lock);
+
+            active = 1 - active;
+            frozenCount = activeCount;
+            activeCount = 0;
+
+            return frozenCount;
+        }
+
+        /**
+         * @brief Walk through the frozen elements
+         *
+         * @param f e.g. [](T& t, bool isLast) {}
+         */
+        template <typename F>
+        void ForEachFrozen(const F& f) {
+            auto& frozen = halves[1 - active];
+            for (int i = 0; i < frozenCount; i++) {
+                f(frozen[i], i == frozenCount - 1);
+            }
+        }
+
+        /**
+         * @brief Discard the frozen elements, leaving its half ready for the
+         * next freeze.
+         */
+        void ReleaseFrozen() {
+            arenas[1 - active].Reset();
+            frozenCount = 0;
+        }
+
+        int FrozenSize() { return frozenCount; }
+
+        /**
+         * @brief Discard all the elements, active and frozen.
+         */
+        void Reset() {
+            Guard l(lock);
+
+            activeCount = 0;
+            frozenCount = 0;
+            arenas[0].Reset();
+            arenas[1].Reset();
+        }
+
+        /**
+         * @brief Number of elements in the active half
+         */
+        int Size() {
+            Guard l(lock);
+
+            return this->activeCount;
+        }
+
+        int Capacity() { return this->bufferSize; }
+
+        using Guard = std::lock_guard<Lock>;
+
+       private:
+        std::array<std::vector<T>, 2> halves;
+        int bufferSize;
+        std::array<StringArena, 2> arenas;
+        int active {0};
+        int activeCount {0};
+        int frozenCount {0};
+        Lock lock;
+    };
 }  // namespace nldb
\ No newline at end of file
@@ -1,12 +1,16 @@
+#pragma once
 
 #include "nldb/DAL/BufferData.hpp"
+#include "nldb/backends/sqlite3/DB/DB.hpp"
 
 namespace nldb {
-    constexpr int max_sql3_query_length = 1000000000;
+    // rows inserted by a single statement while pushing the buffered data
+    constexpr int max_sql3_rows_per_insert = 256;
 
     struct BufferDataSQ3 : public BufferData {
-        BufferDataSQ3(IDB* db, int SmallBufferSize, int MediumBufferSize,
-                      int LargeBufferSize);
+        BufferDataSQ3(DBSL3* db, int SmallBufferSize, int MediumBufferSize,
+                      int LargeBufferSize, int FlushesPerCommit = 1,
+                      int CommitMaxDelayMs = 1000);
 
         void pushRootProperties() override;
         void pushCollections() override;
@@ -14,7 +18,12 @@ namespace nldb {
         void pushIndependentObjects() override;
         void pushDependentObjects() override;
         void pushStringLikeValues() override;
+        void pushIntegerValues() override;
+        void pushDoubleValues() override;
 
         ~BufferDataSQ3();
+
+       private:
+        DBSL3* sq3Conn;
     };
-}  // namespace nldb
\ No newline at end of file
+}  // namespace nldb
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <string>
 #include <unordered_map>
 
+#include "nldb/DAL/UpdateOperator.hpp"
 #include "nldb/Property/Property.hpp"
 
 namespace nldb::definitions {
@@ -11,6 +13,52 @@ namespace nldb::definitions {
      */
     namespace tables {
         std::unordered_map<PropertyType, std::string>& getPropertyTypesTable();
+
+        /**
+         * @brief A query over the table of a property type, written with
+         * `@table` in place of the table name. Tables can't be bound as
+         * parameters, so the query for each table is built only once and
+         * then only the values are bound.
+         */
+        class TableQuery {
+           public:
+            TableQuery(const std::string& sql);
+
+            const std::string& operator[](PropertyType type) const;
+
+           private:
+            std::unordered_map<PropertyType, std::string> queries;
+        };
+    }  // namespace tables
+
+    /**
+     * @brief The value an update operator sets in an upsert, combining the
+     * stored `value` with the `excluded.value` that was being inserted.
+     */
+    std::string inline getOperatorExpression(UpdateOperator op) {
+        switch (op) {
+            case UpdateOperator::MINIMUM:
+                return "min(value, excluded.value)";
+            case UpdateOperator::MAXIMUM:
+                return "max(value, excluded.value)";
+            default:
+                return "value + excluded.value";
+        }
+    }
+
+    /**
+     * @brief Condition that holds if applying the operator to the stored
+     * `value` of an integer and `operand` doesn't overflow it, sqlite would
+     * silently store the result as a REAL.
+     */
+    std::string inline getIntegerOperatorGuard(
+        UpdateOperator op, const std::string& operand = "excluded.value") {
+        if (op != UpdateOperator::INCREMENT) return "true";
+
+        return "((" + operand + " >= 0 and value <= 9223372036854775807 - " +
+               operand + ") or (" + operand +
+               " < 0 and value >= -9223372036854775807 - 1 - " + operand +
+               "))";
     }
 
     std::string inline getSubCollectionName(const std::string& collName,
@@ -15,7 +15,13 @@ namespace nldb {
 
        public:
         void addStringLike(snowflake propID, snowflake objID, PropertyType type,
-                           std::string value) override;
+                           std::string_view value) override;
+
+        void addInteger(snowflake propID, snowflake objID,
+                        int64_t value) override;
+
+        void addDouble(snowflake propID, snowflake objID,
+                       double value) override;
 
         snowflake addObject(snowflake propID,
                             std::optional<snowflake> objID) override;
@@ -24,7 +30,24 @@ namespace nldb {
                                   std::optional<snowflake> objID) override;
 
         void updateStringLike(snowflake propID, snowflake objID,
-                              PropertyType type, std::string value) override;
+                              PropertyType type,
+                              std::string_view value) override;
+
+        void upsertStringLike(snowflake propID, snowflake objID,
+                              PropertyType type,
+                              std::string_view value) override;
+
+        void upsertInteger(snowflake propID, snowflake objID,
+                           int64_t value) override;
+
+        void upsertDouble(snowflake propID, snowflake objID,
+                          double value) override;
+
+        void applyIntegerOperator(snowflake propID, snowflake objID,
+                                  UpdateOperator op, int64_t value) override;
+
+        void applyDoubleOperator(snowflake propID, snowflake objID,
+                                 UpdateOperator op, double value) override;
 
         bool exists(snowflake propID, snowflake objID,
                     PropertyType type) override;
@@ -36,6 +59,16 @@ namespace nldb {
 
         void removeObject(snowflake objID) override;
 
+        void createIndex(snowflake propID, PropertyType type) override;
+
+        void dropIndex(snowflake propID, PropertyType type) override;
+
+        std::vector<snowflake> findIndexedProperties() override;
+
+        void suspendIndex(snowflake propID) override;
+
+        void restoreIndexes() override;
+
        private:
         IDB* conn;
     };
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "DBQueryReader.hpp"
+#include "DBStatement.hpp"
+#include "StatementCache.hpp"
 #include "nldb/DB/IDB.hpp"
 #include "sqlite/sqlite3.h"
 
@@ -18,6 +20,9 @@ namespace nldb {
 
         int page_cache_size = -1;
         int page_cache_N = -1;
+
+        // number of prepared statements to keep for reuse, 0 disables it.
+        int statement_cache_size = 128;
     };
 
     class DBSL3 : public IDB {
@@ -40,6 +45,8 @@ namespace nldb {
 
         void rollback() override;
 
+        bool isInTransaction() override;
+
         std::optional<snowflake> executeAndGetFirstInt(
             const std::string& query, const Paramsbind& params) override;
 
@@ -51,11 +58,37 @@ namespace nldb {
 
         void logStatus() override;
 
+        /**
+         * @brief Prepares a statement to execute it many times binding its
+         * values by position. It's taken from the statements cache if
+         * possible.
+         *
+         * @param query a single statement
+         * @return DBStatementSL3
+         */
+        DBStatementSL3 prepare(const std::string& query);
+
+        /**
+         * @brief Get the maximum number of parameters that a single statement
+         * can have.
+         *
+         * @return int
+         */
+        int getMaxBoundParameters();
+
+        /**
+         * @brief Get the hits/misses of the prepared statements cache.
+         *
+         * @return StatementCacheStats
+         */
+        StatementCacheStats getStatementCacheStats();
+
         ~DBSL3();
 
        private:
-        sqlite3* db;
+        sqlite3* db {nullptr};
         DBConfig config;
         void* page_cache_ptr;
+        StatementCache statements;
     };
 }  // namespace nldb
\ No newline at end of file
@@ -4,6 +4,25 @@
 namespace nldb {
     class DBInitializer {
        public:
+        /**
+         * @brief Version of the schema created by this build, stored in the
+         * database file as its `user_version`.
+         */
+        static constexpr int schemaVersion = 3;
+
         static void createTablesAndFKeys(IDB* db);
+
+        /**
+         * @brief Brings the schema of the database up to `schemaVersion`,
+         * applying the missing migrations in a single transaction.
+         */
+        static void migrate(IDB* db);
+
+        /**
+         * @brief Creates again the indexes suspended by a load, see
+         * IValuesDAO::suspendIndex. Called on open in case the process died
+         * before the load ended.
+         */
+        static void restoreSuspendedIndexes(IDB* db);
     };
 }  // namespace nldb
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include "nldb/DB/IDB.hpp"
 #include "nldb/DB/IDBQueryReader.hpp"
+#include "nldb/backends/sqlite3/DB/StatementCache.hpp"
 #include "sqlite/sqlite3.h"
 
 namespace nldb {
@@ -25,7 +26,16 @@ namespace nldb {
 
     class DBQueryReaderSL3 : public IDBQueryReader {
        public:
-        DBQueryReaderSL3(IDB* db, sqlite3_stmt* stmt);
+        /**
+         * @param db
+         * @param stmt prepared statement to read
+         * @param cache if given, the statement is released to it on
+         * destruction instead of being finalized.
+         * @param sql the sql used to prepare the statement
+         */
+        DBQueryReaderSL3(IDB* db, sqlite3_stmt* stmt,
+                         StatementCache* cache = nullptr,
+                         std::string sql = "");
         ~DBQueryReaderSL3();
 
        public:
@@ -35,5 +45,7 @@ namespace nldb {
         bool allWasRead {false};
         IDB* db;
         sqlite3_stmt* stmt;
+        StatementCache* cache;
+        std::string sql;
     };
 }  // namespace nldb
\ No newline at end of file
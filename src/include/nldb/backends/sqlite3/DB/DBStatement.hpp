@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "nldb/DB/IDB.hpp"
+#include "nldb/backends/sqlite3/DB/StatementCache.hpp"
+#include "sqlite/sqlite3.h"
+
+namespace nldb {
+    /**
+     * @brief A prepared statement meant to be executed many times, binding
+     * its values by position. It's given back to the statements cache once
+     * destroyed.
+     */
+    class DBStatementSL3 {
+       public:
+        DBStatementSL3(IDB* db, sqlite3_stmt* stmt, StatementCache* cache,
+                       std::string sql);
+
+        DBStatementSL3(DBStatementSL3&& other);
+        DBStatementSL3(const DBStatementSL3&) = delete;
+        DBStatementSL3& operator=(const DBStatementSL3&) = delete;
+
+        ~DBStatementSL3();
+
+       public:
+        // Note: SQLITE3 - The leftmost parameter has the index 1
+
+        void bind(int i, int64_t value);
+        void bind(int i, double value);
+        void bind(int i, std::string_view value);
+        void bindNull(int i);
+
+        /**
+         * @brief Runs the statement until it's done and resets it, so it can
+         * be bound and executed again.
+         */
+        void execute();
+
+       private:
+        IDB* db;
+        sqlite3_stmt* stmt;
+        StatementCache* cache;
+        std::string sql;
+    };
+}  // namespace nldb
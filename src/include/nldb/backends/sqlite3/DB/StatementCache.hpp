@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "sqlite/sqlite3.h"
+
+namespace nldb {
+    struct StatementCacheStats {
+        uint64_t hits {0};
+        uint64_t misses {0};
+        size_t size {0};
+    };
+
+    /**
+     * @brief LRU cache of prepared statements keyed by their SQL text.
+     *
+     * A statement is removed from the cache while it's being used, so two
+     * readers never share the same one. Once released it's reset, its
+     * bindings are cleared and becomes the most recently used.
+     */
+    class StatementCache {
+       public:
+        /**
+         * @param capacity maximum number of statements kept, 0 disables it.
+         */
+        StatementCache(size_t capacity);
+        ~StatementCache();
+
+       public:
+        /**
+         * @brief Takes the statement prepared for `sql` out of the cache.
+         *
+         * @param sql
+         * @return sqlite3_stmt* the statement or nullptr if it's not cached,
+         * in that case the caller should prepare it and release it later.
+         */
+        sqlite3_stmt* acquire(const std::string& sql);
+
+        /**
+         * @brief Gives back a statement to the cache. If the cache is full
+         * the least recently used statement is finalized. Statements without
+         * parameters are not kept.
+         *
+         * @param sql the sql used to prepare it
+         * @param stmt
+         */
+        void release(std::string sql, sqlite3_stmt* stmt);
+
+        /**
+         * @brief Finalizes all the cached statements. Required before closing
+         * the connection.
+         */
+        void clear();
+
+        StatementCacheStats getStats();
+
+       private:
+        typedef std::list<std::pair<std::string, sqlite3_stmt*>> Entries;
+
+        std::mutex mtx;
+        size_t capacity;
+
+        // front is the most recently used
+        Entries entries;
+        std::unordered_map<std::string_view, Entries::iterator> index;
+
+        uint64_t hits {0};
+        uint64_t misses {0};
+    };
+}  // namespace nldb
@@ -1,7 +1,9 @@
+#include <functional>
 #include <map>
 #include <utility>
 
 #include "QueryRunnerCtx.hpp"
+#include "SelectPlan.hpp"
 #include "nldb/DAL/Repositories.hpp"
 #include "nldb/DB/IDB.hpp"
 #include "nldb/Object.hpp"
@@ -13,6 +15,74 @@ namespace nldb {
         QueryRunnerSQ3(IDB* connection, std::shared_ptr<Repositories> repos);
 
        public:
+        using QueryRunner::remove;
+        using QueryRunner::update;
+
         json select(QueryPlannerContextSelect&& data) override;
+        long long stream(
+            QueryPlannerContextSelect&& data,
+            const std::function<bool(json&)>& onDocument) override;
+        SelectPage selectPage(QueryPlannerContextSelect&& data) override;
+        json get(QueryPlannerContextGet&& data) override;
+        int update(QueryPlannerContextUpdateWhere&& data) override;
+        int remove(QueryPlannerContextRemoveWhere&& data) override;
+        long long count(QueryPlannerContextCountWhere&& data) override;
+
+       protected:
+        // called with each document read, the row it was read from and the
+        // index of the first column after the document properties
+        using RowCallback = std::function<bool(json&, IDBRowReader&, int)>;
+
+        /**
+         * @brief Builds and runs the select, calling `onRow` with each
+         * document until it returns false.
+         *
+         * @return long long number of documents read
+         */
+        long long runSelect(QueryPlannerContextSelect& data,
+                            const RowCallback& onRow);
+
+        /**
+         * @brief Builds the sql of the select and what's needed to read it.
+         *
+         * @return std::shared_ptr<SelectPlan> the plan, or null if there is
+         * nothing to select
+         */
+        std::shared_ptr<SelectPlan> buildSelectPlan(
+            QueryPlannerContextSelect& data);
+
+        /**
+         * @brief Builds a select of the documents of `rootColl` that satisfy
+         * the where, joining only the properties it uses.
+         *
+         * @param columns what to select, e.g. "__doc.id"
+         * @param params gets the values of the constants of the where, which
+         * are written as parameters
+         */
+        std::string selectMatching(QueryPlannerContextWhere& data,
+                                   const Collection& rootColl,
+                                   const std::string& columns,
+                                   Paramsbind& params);
+
+        /**
+         * @brief Stores the ids of the documents of `rootColl` that satisfy
+         * the where in a temporary table, so the statements that change them
+         * can refer to them even after changing the values that were used to
+         * match them.
+         *
+         * @return int number of documents
+         */
+        int storeMatchingIds(QueryPlannerContextWhere& data,
+                             const Collection& rootColl);
+
+        /**
+         * @brief Sets the values of `object` to all the objects of
+         * `collection` selected by `objects`, adding the sub-objects and
+         * values they are missing.
+         *
+         * @param objects sql query that selects the ids of the objects
+         */
+        void updateMatchingRecursive(const Collection& collection,
+                                     json& object, const std::string& objects);
     };
 }  // namespace nldb
\ No newline at end of file
@@ -52,6 +52,12 @@ namespace nldb {
 
         std::string getValueExpression(const Property& prop);
 
+       public:
+        // write the constants of the where as parameters instead of literals,
+        // numbered in the order they are written
+        bool bindConstants {false};
+        int boundConstants {0};
+
        private:
         // {prop_id, prop_coll_id} -> alias
         // this pair ^ is needed since properties of type ID doesn't have and id
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "lrucache11/LRUCache11.hpp"
+#include "nldb/Property/SortedProperty.hpp"
+#include "nldb/Query/QueryContext.hpp"
+
+namespace nldb {
+    /**
+     * @brief A select already built: its sql, with the values of the where,
+     * the keyset and the pagination as parameters, and what's needed to read
+     * its rows into documents.
+     */
+    struct SelectPlan {
+        std::string sql;
+
+        // the properties read from each row, in the order they are selected
+        std::list<SelectableProperty> columns;
+
+        std::vector<Property> suppressed;
+        std::vector<RenamedProperty> renamed;
+
+        // read after the columns when selecting a page
+        std::vector<SortedProperty> sortBy;
+    };
+
+    /**
+     * @brief The select plans of a query, keyed by the shape of the select
+     * and the catalog version. Plans built before a collection or property
+     * was added are never found again.
+     */
+    struct SelectPlanCache {
+        SelectPlanCache(size_t capacity) : plans(capacity) {}
+
+        lru11::Cache<std::string, std::shared_ptr<SelectPlan>,
+                     std::hash<std::string>, std::mutex>
+            plans;
+    };
+}  // namespace nldb
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <array>
+#include <string>
+#include <string_view>
+
 #include "nldb/Property/Property.hpp"
 #include "nlohmann/json.hpp"
 
@@ -9,4 +13,19 @@ namespace nldb {
     PropertyType JsonTypeToPropertyType(int type);
 
     std::string ValueToString(json& val);
+
+    // where ValueToStringView writes the text of a value, if needed
+    struct ValueText {
+        // enough for any integer or the shortest form of any double
+        std::array<char, 32> number;
+        std::string dumped;
+    };
+
+    /**
+     * @brief Same as ValueToString, but strings are viewed in place and
+     * numbers are formatted into `text`, so only arrays allocate.
+     *
+     * @return std::string_view valid while both `val` and `text` are
+     */
+    std::string_view ValueToStringView(json& val, ValueText& text);
 }  // namespace nldb
\ No newline at end of file
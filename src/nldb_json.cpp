@@ -1,5 +1,8 @@
 #include "nldb/nldb_json.hpp"
 
+#include <charconv>
+#include <cstdint>
+
 #include "magic_enum.hpp"
 #include "nldb/Property/Property.hpp"
 
@@ -30,34 +33,39 @@ namespace nldb {
     }
 
     std::string ValueToString(json& value) {
+        ValueText text;
+        return std::string(ValueToStringView(value, text));
+    }
+
+    std::string_view ValueToStringView(json& value, ValueText& text) {
         PropertyType t = JsonTypeToPropertyType((int)value.type());
 
-        std::string str;
+        auto format = [&text](auto number) {
+            char* begin = text.number.data();
+            char* end =
+                std::to_chars(begin, begin + text.number.size(), number).ptr;
+
+            return std::string_view(begin, end - begin);
+        };
+
         switch (t) {
             case PropertyType::INTEGER:
-                str = std::to_string(value.get<int>());
-                break;
+                return format(value.get<int64_t>());
             case PropertyType::DOUBLE:
-                str = std::to_string(value.get<double>());
-                break;
+                return format(value.get<double>());
             case PropertyType::STRING:
-                str = value.get<std::string>();
-                break;
+                return value.get_ref<const std::string&>();
             case PropertyType::ARRAY:
-                str = value.dump();
-                break;
+                text.dumped = value.dump();
+                return text.dumped;
             case PropertyType::BOOLEAN:
-                str =
-                    std::to_string(value.get<bool>() ? 1 : 0);  // we store ints
-                break;
+                // we store ints
+                return value.get<bool>() ? "1" : "0";
             case PropertyType::OBJECT:
                 throw std::runtime_error(
                     "object type is not allowed to stringify");
-                break;
             default:
                 throw std::runtime_error("uknown type");
         }
-
-        return str;
     }
 }  // namespace nldb
\ No newline at end of file
@@ -1,7 +1,10 @@
 #include <gtest/gtest.h>
 
+#include <filesystem>
+
 #include "DBBaseTest.hpp"
 #include "nldb/backends/sqlite3/DB/DB.hpp"
+#include "nldb/backends/sqlite3/DB/DBInitializer.hpp"
 
 using namespace nldb;
 
@@ -81,4 +84,152 @@ TYPED_TEST(DBTest, TransactionsRollback) {
               2);
     // EXPECT_EQ(db.getChangesCount(), 0); // won't work, "by the most recently
     // completed statement"
-}
\ No newline at end of file
+}
+TYPED_TEST(DBTest, ShouldReusePreparedStatements) {
+    const std::string sql = "SELECT name from user where id = @id;";
+
+    auto before = this->db.getStatementCacheStats();
+
+    for (int id = 1; id <= 2; id++) {
+        auto reader = this->db.executeReader(sql, {{"@id", id}});
+
+        std::shared_ptr<IDBRowReader> row;
+        ASSERT_TRUE(reader->readRow(row));
+        EXPECT_EQ(row->readString(0), "user" + std::to_string(id));
+    }
+
+    auto after = this->db.getStatementCacheStats();
+
+    EXPECT_EQ(after.misses - before.misses, 1);
+    EXPECT_EQ(after.hits - before.hits, 1);
+
+    // a statement in use is not shared
+    auto first = this->db.executeReader(sql, {{"@id", 1}});
+    auto second = this->db.executeReader(sql, {{"@id", 2}});
+
+    std::shared_ptr<IDBRowReader> row1, row2;
+    ASSERT_TRUE(first->readRow(row1));
+    ASSERT_TRUE(second->readRow(row2));
+    EXPECT_EQ(row1->readString(0), "user1");
+    EXPECT_EQ(row2->readString(0), "user2");
+}
+
+TYPED_TEST(DBTest, ShouldBindExecuteParameters) {
+    const std::string sql =
+        "INSERT INTO user (id, name, email) VALUES (@id, @name, @email);";
+
+    // the values are never parsed as sql
+    const std::string name = "o'neil @email";
+
+    auto before = this->db.getStatementCacheStats();
+
+    this->db.execute(sql, {{"@id", 3},
+                           {"@name", name},
+                           {"@email", std::string_view("user3@email.com")}});
+    this->db.execute(
+        sql, {{"@id", 4}, {"@name", name}, {"@email", std::string("-")}});
+
+    auto after = this->db.getStatementCacheStats();
+    EXPECT_EQ(after.hits - before.hits, 1);
+
+    auto reader = this->db.executeReader(
+        "SELECT name, email from user where id = @id;", {{"@id", 3}});
+
+    std::shared_ptr<IDBRowReader> row;
+    ASSERT_TRUE(reader->readRow(row));
+    EXPECT_EQ(row->readString(0), name);
+    EXPECT_EQ(row->readString(1), "user3@email.com");
+}
+
+TYPED_TEST(DBTest, ShouldMigrateOldDatabaseFiles) {
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "nldb_migration_test.db")
+            .string();
+
+    auto removeFiles = [&path]() {
+        for (auto suffix : {"", "-wal", "-shm"}) {
+            std::filesystem::remove(path + suffix);
+        }
+    };
+
+    auto countIndex = [](TypeParam& db, const std::string& name) {
+        return db
+            .executeAndGetFirstInt(
+                "select count(*) from sqlite_master where type = 'index' and "
+                "name = @name;",
+                {{"@name", name}})
+            .value();
+    };
+
+    removeFiles();
+
+    {
+        TypeParam db;
+        ASSERT_TRUE(db.open(path));
+        ASSERT_EQ(db.executeAndGetFirstInt("PRAGMA user_version;", {}),
+                  DBInitializer::schemaVersion);
+        ASSERT_EQ(countIndex(db, "object_obj"), 1);
+
+        // simulate a file created before the structural indexes
+        db.execute("DROP INDEX object_obj; PRAGMA user_version = 0;", {});
+        ASSERT_EQ(countIndex(db, "object_obj"), 0);
+    }
+
+    {
+        TypeParam db;
+        ASSERT_TRUE(db.open(path));
+        EXPECT_EQ(db.executeAndGetFirstInt("PRAGMA user_version;", {}),
+                  DBInitializer::schemaVersion);
+        EXPECT_EQ(countIndex(db, "object_obj"), 1);
+    }
+
+    removeFiles();
+}
+
+TYPED_TEST(DBTest, ShouldKeepTheLastValueWhenMigratingDuplicates) {
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "nldb_migration_test.db")
+            .string();
+
+    auto removeFiles = [&path]() {
+        for (auto suffix : {"", "-wal", "-shm"}) {
+            std::filesystem::remove(path + suffix);
+        }
+    };
+
+    removeFiles();
+
+    {
+        TypeParam db;
+        ASSERT_TRUE(db.open(path));
+
+        // simulate a file created before the values had a unique key
+        db.execute(
+            "DROP INDEX value_int_obj_prop;"
+            "CREATE INDEX value_int_obj_prop ON value_int (obj_id, prop_id);"
+            "PRAGMA user_version = 1;"
+            "INSERT INTO property (id, name, type) VALUES (1, 'p', 0);"
+            "INSERT INTO object (id, prop_id) VALUES (1, 1);"
+            "INSERT INTO value_int (obj_id, prop_id, value) VALUES (1, 1, 5);"
+            "INSERT INTO value_int (obj_id, prop_id, value) VALUES (1, 1, 6);",
+            {});
+    }
+
+    {
+        TypeParam db;
+        ASSERT_TRUE(db.open(path));
+        EXPECT_EQ(db.executeAndGetFirstInt("PRAGMA user_version;", {}),
+                  DBInitializer::schemaVersion);
+        EXPECT_EQ(db.executeAndGetFirstInt("select count(*) from value_int;",
+                                           {}),
+                  1);
+        EXPECT_EQ(db.executeAndGetFirstInt("select value from value_int;", {}),
+                  6);
+
+        EXPECT_ANY_THROW(db.execute(
+            "INSERT INTO value_int (obj_id, prop_id, value) VALUES (1, 1, 7);",
+            {}));
+    }
+
+    removeFiles();
+}
@@ -0,0 +1,273 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include "QueryBase.hpp"
+#include "nldb/Collection.hpp"
+#include "nldb/Common.hpp"
+#include "nldb/Exceptions.hpp"
+
+using namespace nldb;
+
+template <typename T>
+class QueryBufferTests : public QueryBaseTest<T> {
+   public:
+    int countDocuments(Query<T>& query, const char* collection) {
+        return query.from(collection).select().execute().size();
+    }
+};
+
+TYPED_TEST_SUITE(QueryBufferTests, TestDBTypes);
+
+TYPED_TEST(QueryBufferTests, ShouldFlushAtomically) {
+    auto id = common::internal_id_string;
+
+    this->q.from("test").insert(
+        {{id, 42}, {"name", "a"}, {"inner", {{"x", 0}}}});
+
+    // the document is written before its inner object, which fails
+    ASSERT_ANY_THROW(this->q.from("test").insert(
+        {{id, 50}, {"name", "b"}, {"inner", {{id, 42}, {"x", 1}}}}));
+
+    ASSERT_FALSE(this->db.isInTransaction());
+
+    json result = this->q.from("test").select().execute();
+    ASSERT_EQ(result.size(), 1);
+    ASSERT_EQ(result[0]["name"], "a");
+}
+
+TYPED_TEST(QueryBufferTests, ShouldCoalesceFlushes) {
+    QueryConfiguration cfg;
+    cfg.FlushesPerCommit = 3;
+
+    Query<TypeParam> query(&this->db, cfg);
+
+    // each insert flushes
+    query.from("test").insert({{"name", "a"}});
+    ASSERT_TRUE(this->db.isInTransaction());
+
+    query.from("test").insert({{"name", "b"}});
+    ASSERT_TRUE(this->db.isInTransaction());
+
+    // uncommitted data is visible to the same connection
+    ASSERT_EQ(this->countDocuments(query, "test"), 2);
+
+    query.from("test").insert({{"name", "c"}});
+    ASSERT_FALSE(this->db.isInTransaction());
+
+    query.from("test").insert({{"name", "d"}});
+    ASSERT_TRUE(this->db.isInTransaction());
+
+    query.getRepositories()->commitPendingData();
+    ASSERT_FALSE(this->db.isInTransaction());
+
+    ASSERT_EQ(this->countDocuments(query, "test"), 4);
+}
+
+TYPED_TEST(QueryBufferTests, ShouldCommitBeforeWritingWithoutTheBuffer) {
+    auto id = common::internal_id_string;
+
+    QueryConfiguration cfg;
+    cfg.FlushesPerCommit = 3;
+
+    Query<TypeParam> query(&this->db, cfg);
+
+    query.from("test").insert({{id, 42}, {"name", "a"}});
+    ASSERT_TRUE(this->db.isInTransaction());
+
+    query.from("test").remove(42);
+    ASSERT_FALSE(this->db.isInTransaction());
+
+    // the failed flush doesn't roll back the removal
+    query.from("test").insert({{id, 50}, {"name", "b"}});
+    ASSERT_ANY_THROW(query.from("test").insert({{id, 50}, {"name", "c"}}));
+
+    ASSERT_FALSE(this->db.isInTransaction());
+    ASSERT_EQ(this->countDocuments(query, "test"), 0);
+}
+
+TYPED_TEST(QueryBufferTests, ShouldCommitCoalescedFlushesAfterMaxDelay) {
+    QueryConfiguration cfg;
+    cfg.FlushesPerCommit = 100;
+    cfg.CommitMaxDelayMs = 20;
+
+    Query<TypeParam> query(&this->db, cfg);
+
+    query.from("test").insert({{"name", "a"}});
+    ASSERT_TRUE(this->db.isInTransaction());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+
+    query.from("test").insert({{"name", "b"}});
+    ASSERT_FALSE(this->db.isInTransaction());
+}
+
+TYPED_TEST(QueryBufferTests, ShouldFlushInBackground) {
+    QueryConfiguration cfg;
+    cfg.BackgroundFlush = true;
+    cfg.FlushMaxLatencyMs = 10;
+
+    Query<TypeParam> query(&this->db, cfg);
+
+    query.from("test").insert(
+        {{{"name", "a"}}, {{"name", "b"}}, {{"name", "c"}}});
+
+    // reading the tables doesn't flush the buffers, only the flusher does
+    auto countWritten = [this, &query]() {
+        std::lock_guard<std::recursive_mutex> lock(
+            query.getRepositories()->mtx);
+        return this->db
+            .executeAndGetFirstInt("select count(*) from value_string;", {})
+            .value();
+    };
+
+    for (int i = 0; i < 200 && countWritten() < 3; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    ASSERT_EQ(countWritten(), 3);
+    ASSERT_FALSE(this->db.isInTransaction());
+
+    query.from("test").insert({{"name", "d"}});
+    ASSERT_EQ(this->countDocuments(query, "test"), 4);
+}
+
+TYPED_TEST(QueryBufferTests, ShouldReportFailedBackgroundFlushes) {
+    QueryConfiguration cfg;
+    cfg.BackgroundFlush = true;
+    cfg.FlushMaxLatencyMs = 10;
+
+    Query<TypeParam> query(&this->db, cfg);
+
+    this->db.execute(
+        "create trigger fail_flush before insert on value_string begin "
+        "select raise(abort, 'failed flush'); end;",
+        {});
+
+    query.from("test").insert({{"name", "a"}});
+
+    // give the flusher time to fail on its own
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    ASSERT_ANY_THROW(query.from("test").select().execute());
+
+    // reported only once, the data is gone
+    this->db.execute("drop trigger fail_flush;", {});
+    ASSERT_EQ(this->countDocuments(query, "test"), 0);
+}
+
+TYPED_TEST(QueryBufferTests, ShouldIngestFromManyThreadsWhileFlushing) {
+    QueryConfiguration cfg;
+    cfg.BackgroundFlush = true;
+    cfg.FlushMaxLatencyMs = 1;
+    // a few documents fill them
+    cfg.MediumBufferSize = 1000;
+    cfg.LargeBufferSize = 2000;
+
+    Query<TypeParam> query(&this->db, cfg);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&query, t]() {
+            for (int i = 0; i < 100; i++) {
+                query.from("test").insert(
+                    {{"thread", t}, {"i", i}, {"inner", {{"x", i}}}});
+            }
+        });
+    }
+
+    for (auto& thread : threads) thread.join();
+
+    ASSERT_EQ(this->countDocuments(query, "test"), 400);
+}
+
+TYPED_TEST(QueryBufferTests, ShouldUpdateDocumentsStillBuffered) {
+    QueryConfiguration cfg;
+    cfg.BackgroundFlush = true;
+    cfg.FlushMaxLatencyMs = 10000;
+
+    Query<TypeParam> query(&this->db, cfg);
+
+    auto ids = query.from("test").insert({{"name", "a"}});
+    query.from("test").update(ids[0], {{"name", "b"}});
+
+    json result = query.from("test").select().execute();
+    ASSERT_EQ(result.size(), 1);
+    ASSERT_EQ(result[0]["name"], "b");
+
+    query.from("test").remove(ids[0]);
+    ASSERT_EQ(this->countDocuments(query, "test"), 0);
+}
+
+TYPED_TEST(QueryBufferTests, ShouldFlushForOperatorsOnlyIfTheValueIsBuffered) {
+    auto& valuesDAO = this->q.getRepositories()->valuesDAO;
+
+    auto countWritten = [this]() {
+        return this->db
+            .executeAndGetFirstInt("select count(*) from value_int;", {})
+            .value();
+    };
+
+    valuesDAO->addInteger(1, 10, 1);
+
+    // another value, the buffered one can wait
+    valuesDAO->applyIntegerOperator(2, 10, UpdateOperator::INCREMENT, 1);
+    ASSERT_EQ(countWritten(), 1);
+
+    // it's written before combining it
+    valuesDAO->applyIntegerOperator(1, 10, UpdateOperator::INCREMENT, 1);
+    ASSERT_EQ(countWritten(), 2);
+
+    ASSERT_EQ(this->db.executeAndGetFirstInt(
+                  "select value from value_int where prop_id = 1;", {}),
+              2);
+}
+
+TYPED_TEST(QueryBufferTests, ShouldStageValuesUntilMerged) {
+    auto repos = this->q.getRepositories();
+
+    auto countWritten = [this]() {
+        return this->db
+            .executeAndGetFirstInt("select count(*) from value_int;", {})
+            .value();
+    };
+
+    {
+        auto staging = repos->stageValues();
+        ASSERT_TRUE(staging.has_value());
+
+        repos->valuesDAO->addInteger(1, 10, 1);
+
+        // other threads add to the shared buffers
+        std::thread([&repos]() {
+            repos->valuesDAO->addInteger(1, 20, 2);
+        }).join();
+
+        repos->pushPendingData();
+        ASSERT_EQ(countWritten(), 1);
+
+        staging->merge();
+        repos->pushPendingData();
+        ASSERT_EQ(countWritten(), 2);
+
+        // not merged, it's discarded
+        repos->valuesDAO->addInteger(1, 30, 3);
+    }
+
+    repos->valuesDAO->addInteger(1, 40, 4);
+    repos->pushPendingData();
+    ASSERT_EQ(countWritten(), 3);
+}
+
+TYPED_TEST(QueryBufferTests, ShouldNotWriteAnyDocumentOfAFailedInsert) {
+    this->q.from("test").insert({{"n", 1}});
+
+    ASSERT_THROW(this->q.from("test").insert(
+                     {{{"n", 2}, {"inner", {{"x", 1}}}}, {{"n", "three"}}}),
+                 WrongPropertyType);
+
+    json result = this->q.from("test").select().execute();
+    ASSERT_EQ(result.size(), 1);
+    ASSERT_EQ(result[0]["n"], 1);
+}
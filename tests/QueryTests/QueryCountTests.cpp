@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include "QueryBaseCars.hpp"
+#include "nldb/Collection.hpp"
+#include "nldb/Exceptions.hpp"
+
+template <typename T>
+class QueryCountTestsCars : public QueryCarsTest<T> {};
+TYPED_TEST_SUITE(QueryCountTestsCars, TestDBTypes);
+
+TYPED_TEST(QueryCountTestsCars, ShouldCountDocuments) {
+    Collection cars = this->q.collection("cars");
+
+    ASSERT_EQ(this->q.from("cars").count(), 3);
+    ASSERT_EQ(this->q.from("cars").where(cars["maker"] == "ford").count(), 2);
+    ASSERT_EQ(this->q.from("cars")
+                  .where(cars["technical"]["0-60 mph"] > 4)
+                  .where(cars["year"] < 2015)
+                  .count(),
+              1);
+    ASSERT_EQ(this->q.from("cars").where(cars["year"] > 3000).count(), 0);
+    ASSERT_EQ(this->q.from("boats").count(), 0);
+
+    // the buffered documents are counted too
+    this->q.from("cars").insert({{"maker", "ford"}});
+    ASSERT_EQ(this->q.from("cars").where(cars["maker"] == "ford").count(), 3);
+}
+
+TYPED_TEST(QueryCountTestsCars, ShouldCheckIfDocumentsExist) {
+    Collection cars = this->q.collection("cars");
+
+    ASSERT_TRUE(this->q.from("cars").exists());
+    ASSERT_TRUE(this->q.from("cars").where(cars["year"] == 2003).exists());
+    ASSERT_FALSE(this->q.from("cars").where(cars["year"] == 1).exists());
+    ASSERT_FALSE(this->q.from("boats").exists());
+}
+
+TYPED_TEST(QueryCountTestsCars, ShouldNotCountWithMissingProperty) {
+    Collection cars = this->q.collection("cars");
+
+    ASSERT_THROW(this->q.from("cars").where(cars["color"] == "red").count(),
+                 PropertyNotFound);
+}
+
+TYPED_TEST(QueryCountTestsCars, ShouldReuseTheStatementsWithOtherValues) {
+    Collection cars = this->q.collection("cars");
+
+    auto byYear = [&](int year) {
+        return this->q.from("cars").where(cars["year"] == year).count();
+    };
+
+    auto anyBy = [&](const char* maker) {
+        return this->q.from("cars").where(cars["maker"] == maker).exists();
+    };
+
+    ASSERT_EQ(byYear(2011), 1);
+    ASSERT_TRUE(anyBy("ford"));
+
+    auto before = this->db.getStatementCacheStats();
+
+    ASSERT_EQ(byYear(2003), 1);
+    ASSERT_EQ(byYear(1990), 0);
+    ASSERT_TRUE(anyBy("subaru"));
+    ASSERT_FALSE(anyBy("kia"));
+
+    auto after = this->db.getStatementCacheStats();
+
+    EXPECT_EQ(after.misses, before.misses);
+}
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+#include "QueryBaseCars.hpp"
+#include "nldb/Collection.hpp"
+#include "nldb/Common.hpp"
+
+using namespace nldb;
+
+template <typename T>
+class QueryGetTestsCars : public QueryCarsTest<T> {};
+TYPED_TEST_SUITE(QueryGetTestsCars, TestDBTypes);
+
+TYPED_TEST(QueryGetTestsCars, ShouldGetTheSameDocumentsAsSelect) {
+    // deeper sub-documents and booleans
+    this->q.from("cars").insert(
+        {{"maker", "kia"},
+         {"electric", true},
+         {"technical", {{"engine", {{"power", 201}, {"torque", 4.5}}}}}});
+
+    json cars = this->q.from("cars").select().execute();
+
+    ASSERT_EQ(cars.size(), 4);
+
+    for (auto& car : cars) {
+        const std::string id = car[common::internal_id_string];
+        auto found = this->q.from("cars").get(id);
+
+        ASSERT_TRUE(found.has_value());
+        ASSERT_EQ(found.value(), car);
+    }
+}
+
+TYPED_TEST(QueryGetTestsCars, ShouldGetManyDocumentsInOrder) {
+    Collection cars = this->q.collection("cars");
+    json all =
+        this->q.from("cars").select().sortBy(cars["year"].asc()).execute();
+
+    ASSERT_EQ(all.size(), 3);
+
+    const std::string first = all[0][common::internal_id_string];
+    const std::string last = all[2][common::internal_id_string];
+
+    // missing and repeated ids are left out
+    json found = this->q.from("cars").getMany({last, "123456", first, last});
+
+    ASSERT_EQ(found.size(), 2);
+    ASSERT_EQ(found[0], all[2]);
+    ASSERT_EQ(found[1], all[0]);
+
+    ASSERT_EQ(this->q.from("cars").getMany({}).size(), 0);
+}
+
+TYPED_TEST(QueryGetTestsCars, ShouldNotGetMissingDocuments) {
+    json car = this->q.from("cars").select().limit(1).execute()[0];
+    const std::string id = car[common::internal_id_string];
+
+    ASSERT_FALSE(this->q.from("cars").get("123456").has_value());
+
+    // documents from other collections
+    ASSERT_FALSE(this->q.from("automaker").get(id).has_value());
+    ASSERT_FALSE(this->q.from("boats").get(id).has_value());
+
+    ASSERT_THROW(this->q.from("cars").get("not an id"), std::runtime_error);
+
+    this->q.from("cars").remove(id);
+    ASSERT_FALSE(this->q.from("cars").get(id).has_value());
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include "QueryBase.hpp"
+#include "QueryBaseCars.hpp"
+#include "nldb/Collection.hpp"
+#include "nldb/Exceptions.hpp"
+
+using namespace nldb;
+
+template <typename T>
+class QueryIndexTestsCars : public QueryCarsTest<T> {
+   public:
+    int countIndexes() {
+        return this->db
+            .executeAndGetFirstInt(
+                "select count(*) from sqlite_master where type = 'index' and "
+                "name like 'idx_prop_%';",
+                {})
+            .value();
+    }
+};
+TYPED_TEST_SUITE(QueryIndexTestsCars, TestDBTypes);
+
+TYPED_TEST(QueryIndexTestsCars, ShouldCreateAndDropIndex) {
+    Collection cars = this->q.collection("cars");
+
+    this->q.from("cars").createIndex(cars["year"]);
+    this->q.from("cars").createIndex(cars["technical"]["weight"]);
+
+    ASSERT_EQ(this->countIndexes(), 2);
+
+    // creating it again is a no-op
+    this->q.from("cars").createIndex(cars["year"]);
+    ASSERT_EQ(this->countIndexes(), 2);
+
+    this->q.from("cars").dropIndex(cars["year"]);
+    ASSERT_EQ(this->countIndexes(), 1);
+}
+
+TYPED_TEST(QueryIndexTestsCars, ShouldSelectUsingIndexedProperty) {
+    Collection cars = this->q.collection("cars");
+
+    this->q.from("cars").createIndex(cars["year"]);
+
+    json result = this->q.from("cars")
+                      .select(cars["model"])
+                      .where(cars["year"] > 2010)
+                      .sortBy(cars["year"].asc())
+                      .execute();
+
+    ASSERT_EQ(result.size(), 2);
+    ASSERT_EQ(result[0]["model"], "focus");
+
+    // new values are also indexed
+    this->q.from("cars").insert(
+        {{"maker", "subaru"}, {"model", "wrx"}, {"year", 2020}});
+
+    result = this->q.from("cars")
+                 .select(cars["model"])
+                 .where(cars["year"] > 2016)
+                 .execute();
+
+    ASSERT_EQ(result.size(), 1);
+    ASSERT_EQ(result[0]["model"], "wrx");
+}
+
+TYPED_TEST(QueryIndexTestsCars, ShouldNotIndexObjectsOrMissingProperties) {
+    Collection cars = this->q.collection("cars");
+
+    ASSERT_ANY_THROW(this->q.from("cars").createIndex(cars["technical"]));
+    ASSERT_THROW(this->q.from("cars").createIndex(cars["color"]),
+                 PropertyNotFound);
+}
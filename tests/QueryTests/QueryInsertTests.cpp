@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <cstdint>
+
 #include "QueryBase.hpp"
 #include "nldb/Collection.hpp"
 #include "nldb/Common.hpp"
@@ -105,4 +107,131 @@ TYPED_TEST(QueryInsertTests, ShouldMaybeNotThrowOnIntegerIntoDouble) {
         ADD_FAILURE() << "Unexpected exception thrown";
     }
 #endif
-}
\ No newline at end of file
+}
+
+TYPED_TEST(QueryInsertTests, ShouldCheckTypesWithinTheSameBatch) {
+    EXPECT_NO_THROW(this->q.from("test").insert(
+        {{{"magic", 20.15}, {"inner", {{"n", 1}}}},
+         {{"magic", 1}, {"inner", {{"n", 2}}}}}));
+
+    EXPECT_THROW(this->q.from("test").insert(
+                     {{{"inner", {{"n", 3}}}}, {{"inner", {{"n", "three"}}}}}),
+                 WrongPropertyType);
+
+    Collection test = this->q.collection("test");
+    json selected =
+        this->q.from("test").select().sortBy(test["magic"].desc()).execute();
+
+    ASSERT_GE(selected.size(), 2);
+    ASSERT_EQ(selected[0]["magic"], 20.15);
+    ASSERT_EQ(selected[0]["inner"]["n"], 1);
+    ASSERT_EQ(selected[1]["magic"], 1);
+    ASSERT_EQ(selected[1]["inner"]["n"], 2);
+}
+
+TYPED_TEST(QueryInsertTests, ShouldInsertMoreDocumentsThanAStatementFits) {
+    Collection test = this->q.collection("test");
+
+    // more rows than a single insert statement takes, plus some remainder
+    const int count = 1000;
+
+    json docs = json::array();
+    for (int i = 0; i < count; i++) {
+        docs.push_back({{"name", "o'neil " + std::to_string(i)},
+                        {"number", i},
+                        {"inner", {{"value", i * 0.5}}}});
+    }
+
+    this->q.from("test").insert(docs);
+
+    json selected = this->q.from("test")
+                        .select()
+                        .sortBy(test["number"].asc())
+                        .page(1)
+                        .limit(count * 2)
+                        .execute();
+
+    ASSERT_EQ(selected.size(), count);
+    ASSERT_EQ(selected[count - 1]["name"], "o'neil 999");
+    ASSERT_EQ(selected[count - 1]["number"], 999);
+    ASSERT_EQ(selected[count - 1]["inner"]["value"], 499.5);
+}
+
+TYPED_TEST(QueryInsertTests, ShouldKeepNumbersAsTheyAre) {
+    // past int and std::to_string's six decimals
+    const int64_t big = 9007199254740993LL;
+    const double precise = 0.1234567891;
+
+    this->q.from("test").insert(
+        {{"big", big}, {"precise", precise}, {"flag", true}});
+
+    json selected = this->q.from("test").select().execute();
+
+    ASSERT_EQ(selected.size(), 1);
+    ASSERT_EQ(selected[0]["big"], big);
+    ASSERT_DOUBLE_EQ(selected[0]["precise"].get<double>(), precise);
+    ASSERT_EQ(selected[0]["flag"], true);
+}
+
+TYPED_TEST(QueryInsertTests, ShouldInsertRawJson) {
+    auto id = common::internal_id_string;
+    Collection test = this->q.collection("test");
+
+    std::vector<std::string> ids = this->q.from("test").insertRaw(
+        R"([{"name": "a", "n": 1, "tags": [1, {"x": null}],)"
+        R"(   "inner": {"b": true}},)"
+        R"( {"n": 2, "d": 2.5, "_id": "42", "skip": null,)"
+        R"(   "inner": {"b": false}}])");
+
+    ASSERT_EQ(ids.size(), 2);
+    ASSERT_EQ(ids[1], "42");
+
+    json selected =
+        this->q.from("test").select().sortBy(test["n"].asc()).execute();
+
+    ASSERT_EQ(selected.size(), 2);
+    ASSERT_EQ(selected[0][id], ids[0]);
+    ASSERT_EQ(selected[0]["name"], "a");
+    ASSERT_EQ(selected[0]["n"], 1);
+    ASSERT_EQ(selected[0]["tags"], json::parse(R"([1, {"x": null}])"));
+    ASSERT_EQ(selected[0]["inner"]["b"], true);
+    ASSERT_EQ(selected[1][id], "42");
+    ASSERT_EQ(selected[1]["n"], 2);
+    ASSERT_EQ(selected[1]["d"], 2.5);
+    ASSERT_EQ(selected[1]["inner"]["b"], false);
+    ASSERT_FALSE(selected[1].contains("skip"));
+}
+
+TYPED_TEST(QueryInsertTests, ShouldCheckTypesOnRawJson) {
+    this->q.from("test").insertRaw(R"({"magic": 20.15})");
+
+    EXPECT_NO_THROW(this->q.from("test").insertRaw(R"({"magic": 1})"));
+    EXPECT_THROW(this->q.from("test").insertRaw(R"({"magic": "a"})"),
+                 WrongPropertyType);
+    EXPECT_ANY_THROW(this->q.from("test").insertRaw(R"({"magic": )"));
+}
+
+TYPED_TEST(QueryInsertTests, ShouldNotInsertAnyDocumentOfInvalidRawJson) {
+    // the first document is complete when the text fails
+    EXPECT_ANY_THROW(this->q.from("test").insertRaw(
+        R"([{"name": "a", "inner": {"x": 1}}, {"name": "b", ])"));
+
+    ASSERT_FALSE(this->db.isInTransaction());
+
+    this->q.from("test").insertRaw(R"({"name": "c"})");
+
+    json selected = this->q.from("test").select().execute();
+    ASSERT_EQ(selected.size(), 1);
+    ASSERT_EQ(selected[0]["name"], "c");
+}
+
+TYPED_TEST(QueryInsertTests, ShouldRejectRawIntegersOutOfRange) {
+    this->q.from("test").insertRaw(R"({"n": 9223372036854775807})");
+
+    EXPECT_ANY_THROW(
+        this->q.from("test").insertRaw(R"({"n": 9223372036854775808})"));
+
+    json selected = this->q.from("test").select().execute();
+    ASSERT_EQ(selected.size(), 1);
+    ASSERT_EQ(selected[0]["n"], INT64_MAX);
+}
@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <functional>
+#include <sstream>
+#include <utility>
+
+#include "QueryBase.hpp"
+#include "nldb/Collection.hpp"
+#include "nldb/Exceptions.hpp"
+
+using namespace nldb;
+
+template <typename T>
+class QueryLoadTests : public QueryBaseTest<T> {
+   public:
+    json selectSorted() {
+        Collection test = this->q.collection("test");
+
+        return this->q.from("test")
+            .select()
+            .sortBy(test["n"].asc())
+            .page(1)
+            .limit(100)
+            .execute();
+    }
+};
+
+TYPED_TEST_SUITE(QueryLoadTests, TestDBTypes);
+
+TYPED_TEST(QueryLoadTests, ShouldLoadJsonArray) {
+    std::stringstream input(
+        R"([{"n": 1, "name": "a", "inner": {"x": [1, 2]}}, {"n": 2},)"
+        R"( {"n": 3, "name": "c"}])");
+
+    LoadStats stats = this->q.from("test").load(input, 2);
+
+    ASSERT_EQ(stats.documents, 3);
+
+    json result = this->selectSorted();
+    ASSERT_EQ(result.size(), 3);
+    ASSERT_EQ(result[0]["name"], "a");
+    ASSERT_EQ(result[0]["inner"]["x"], json::array({1, 2}));
+    ASSERT_EQ(result[2]["name"], "c");
+}
+
+TYPED_TEST(QueryLoadTests, ShouldLoadNewlineDelimitedJson) {
+    std::stringstream input(
+        "{\"n\": 1, \"name\": \"a\"}\n"
+        "\n"
+        "{\"n\": 2, \"name\": \"b\"}\r\n"
+        "{\"n\": 3, \"name\": \"c\"}");
+
+    LoadStats stats = this->q.from("test").load(input);
+
+    ASSERT_EQ(stats.documents, 3);
+
+    json result = this->selectSorted();
+    ASSERT_EQ(result.size(), 3);
+    ASSERT_EQ(result[1]["name"], "b");
+}
+
+TYPED_TEST(QueryLoadTests, ShouldRestoreIndexesAfterLoading) {
+    Collection test = this->q.collection("test");
+
+    this->q.from("test").insert({{"n", 0}});
+    this->q.from("test").createIndex(test["n"]);
+
+    std::stringstream input("{\"n\": 1}\n{\"n\": 2}\n");
+    this->q.from("test").load(input);
+
+    auto indexes = this->db.executeAndGetFirstInt(
+        "select count(*) from sqlite_master where type = 'index' and name "
+        "like 'idx_prop_%';",
+        {});
+    ASSERT_EQ(indexes.value(), 1);
+
+    ASSERT_EQ(this->selectSorted().size(), 3);
+}
+
+TYPED_TEST(QueryLoadTests, ShouldSuspendOnlyTheIndexesOfTheLoadedCollection) {
+    Collection test = this->q.collection("test");
+    Collection other = this->q.collection("other");
+
+    this->q.from("test").insert({{"n", 0}, {"inner", {{"x", 0}}}});
+    this->q.from("other").insert({{"n", 0}});
+
+    this->q.from("test").createIndex(test["n"]);
+    this->q.from("test").createIndex(test["inner"]["x"]);
+    this->q.from("other").createIndex(other["n"]);
+
+    auto countIndexes = [this]() {
+        return this->db
+            .executeAndGetFirstInt(
+                "select count(*) from sqlite_master where type = 'index' and "
+                "name like 'idx_prop_%';",
+                {})
+            .value();
+    };
+
+    // counts them once the whole input was read, before they are restored
+    struct InputEnd : std::stringbuf {
+        InputEnd(const std::string& str, std::function<void()> pOnEnd)
+            : std::stringbuf(str), onEnd(std::move(pOnEnd)) {}
+
+        int_type underflow() override {
+            if (onEnd) std::exchange(onEnd, nullptr)();
+            return std::stringbuf::underflow();
+        }
+
+        std::function<void()> onEnd;
+    };
+
+    int whileLoading = -1;
+    InputEnd buffer("{\"n\": 1, \"inner\": {\"x\": 1}}\n",
+                    [&]() { whileLoading = countIndexes(); });
+
+    std::istream input(&buffer);
+    this->q.from("test").load(input);
+
+    ASSERT_EQ(whileLoading, 1);
+    ASSERT_EQ(countIndexes(), 3);
+}
+
+TYPED_TEST(QueryLoadTests, ShouldThrowOnMalformedInput) {
+    Collection test = this->q.collection("test");
+
+    this->q.from("test").insert({{"n", 0}});
+    this->q.from("test").createIndex(test["n"]);
+
+    std::stringstream input("{\"n\": 1}\n{\"n\": \n");
+    ASSERT_ANY_THROW(this->q.from("test").load(input));
+
+    auto indexes = this->db.executeAndGetFirstInt(
+        "select count(*) from sqlite_master where type = 'index' and name "
+        "like 'idx_prop_%';",
+        {});
+    ASSERT_EQ(indexes.value(), 1);
+}
+
+TYPED_TEST(QueryLoadTests, ShouldRestoreIndexesOfUnfinishedLoadsOnOpen) {
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "nldb_load_test.db")
+            .string();
+
+    auto removeFiles = [&path]() {
+        for (auto suffix : {"", "-wal", "-shm"}) {
+            std::filesystem::remove(path + suffix);
+        }
+    };
+
+    auto countIndexes = [](TypeParam& db) {
+        return db
+            .executeAndGetFirstInt(
+                "select count(*) from sqlite_master where type = 'index' and "
+                "name like 'idx_prop_%';",
+                {})
+            .value();
+    };
+
+    removeFiles();
+
+    {
+        TypeParam db;
+        ASSERT_TRUE(db.open(path));
+
+        Query<TypeParam> query(&db);
+        Collection test = query.collection("test");
+
+        query.from("test").insert({{"n", 0}});
+        query.from("test").createIndex(test["n"]);
+
+        // as a load does before dying halfway
+        auto& valuesDAO = query.getRepositories()->valuesDAO;
+        for (snowflake propID : valuesDAO->findIndexedProperties()) {
+            valuesDAO->suspendIndex(propID);
+        }
+
+        ASSERT_EQ(countIndexes(db), 0);
+    }
+
+    {
+        TypeParam db;
+        ASSERT_TRUE(db.open(path));
+
+        EXPECT_EQ(countIndexes(db), 1);
+        EXPECT_EQ(
+            db.executeAndGetFirstInt("select count(*) from suspended_index;",
+                                     {}),
+            0);
+    }
+
+    removeFiles();
+}
@@ -53,4 +53,93 @@ TYPED_TEST(QueryRemoveTestsCars, ShouldRemoveInnerDocument) {
 
     ASSERT_EQ(afterRemove.size(), 1);
     ASSERT_FALSE(afterRemove[0].contains("technical"));
-}
\ No newline at end of file
+}
+
+TYPED_TEST(QueryRemoveTestsCars, ShouldRemoveTheSubDocuments) {
+    auto count = [this](const char* table) {
+        return this->db
+            .executeAndGetFirstInt(std::string("select count(*) from ") +
+                                       table + ";",
+                                   {})
+            .value();
+    };
+
+    json result = this->q.from("cars").select().execute();
+
+    for (auto& car : result) {
+        this->q.from("cars").remove(
+            car[common::internal_id_string].get<std::string>());
+    }
+
+    // the automakers are left
+    ASSERT_EQ(count("object"), this->data_automaker.size());
+    ASSERT_EQ(count("value_double"), 0);
+    ASSERT_EQ(count("value_array"), 0);
+}
+
+TYPED_TEST(QueryRemoveTestsCars, ShouldRemoveByWhere) {
+    Collection cars = this->q.collection("cars");
+
+    const int removed =
+        this->q.from("cars").where(cars["maker"] == "ford").remove();
+
+    ASSERT_EQ(removed, 2);
+
+    json result = this->q.from("cars").select().execute();
+
+    ASSERT_EQ(result.size(), 1);
+    ASSERT_EQ(result[0]["maker"], "subaru");
+    ASSERT_NEAR(result[0]["technical"]["0-60 mph"], 3.1, 1e-2);
+
+    // only the technical of the subaru is left
+    json technical =
+        this->q.from("_cars_technical").select().includeInnerIds().execute();
+    ASSERT_EQ(technical.size(), 1);
+
+    ASSERT_EQ(this->q.from("automaker").select().execute().size(),
+              this->data_automaker.size());
+}
+
+TYPED_TEST(QueryRemoveTestsCars, ShouldRemoveByWhereOnInnerFields) {
+    Collection cars = this->q.collection("cars");
+
+    const int removed = this->q.from("cars")
+                            .where(cars["technical"]["0-60 mph"] < 4)
+                            .where(cars["year"] > 2000)
+                            .remove();
+
+    ASSERT_EQ(removed, 1);
+
+    json result = this->q.from("cars").select().execute();
+    ASSERT_EQ(result.size(), 2);
+
+    for (auto& car : result) ASSERT_EQ(car["maker"], "ford");
+
+    ASSERT_EQ(this->q.from("cars").where(cars["year"] > 3000).remove(), 0);
+    ASSERT_EQ(this->q.from("cars").select().execute().size(), 2);
+}
+
+TYPED_TEST(QueryRemoveTestsCars, ShouldRemoveAllOrNothing) {
+    Collection cars = this->q.collection("cars");
+
+    // the values are deleted before the objects, which fail
+    this->db.execute(
+        "create trigger fail_remove before delete on object begin "
+        "select raise(abort, 'failed remove'); end;",
+        {});
+
+    ASSERT_ANY_THROW(
+        this->q.from("cars").where(cars["maker"] == "ford").remove());
+
+    json car = this->q.from("cars").select().limit(1).execute()[0];
+    ASSERT_ANY_THROW(this->q.from("cars").remove(
+        car[common::internal_id_string].get<std::string>()));
+
+    ASSERT_FALSE(this->db.isInTransaction());
+    this->db.execute("drop trigger fail_remove;", {});
+
+    json result = this->q.from("cars").select().execute();
+    ASSERT_EQ(result.size(), this->data_cars.size());
+
+    for (auto& car : result) ASSERT_TRUE(car.contains("technical"));
+}
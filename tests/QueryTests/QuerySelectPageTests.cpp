@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <set>
+
 #include "QueryBaseCars.hpp"
 #include "nldb/Collection.hpp"
 
@@ -69,4 +71,108 @@ TYPED_TEST(QueryPageTests, ShouldSelectNoneIfNoElementsInPage) {
                     .execute();
 
     ASSERT_EQ(res2.size(), 0) << res2;
-}
\ No newline at end of file
+}
+TYPED_TEST(QueryPageTests, ShouldSelectPagesAfterAndBeforeTokens) {
+    Collection cars = this->q.collection("cars");
+
+    auto query = [&]() {
+        return std::move(this->q.from("cars")
+                             .select(cars["year"])
+                             .sortBy(cars["year"].asc())
+                             .limit(1));
+    };
+
+    SelectPage first = query().executePage();
+    ASSERT_EQ(first.documents.size(), 1);
+    ASSERT_EQ(first.documents[0]["year"], 2003);
+    ASSERT_TRUE(first.previous.empty());
+    ASSERT_FALSE(first.next.empty());
+
+    SelectPage second = query().after(first.next).executePage();
+    ASSERT_EQ(second.documents.size(), 1);
+    ASSERT_EQ(second.documents[0]["year"], 2011);
+    ASSERT_FALSE(second.previous.empty());
+
+    SelectPage last = query().after(second.next).executePage();
+    ASSERT_EQ(last.documents.size(), 1);
+    ASSERT_EQ(last.documents[0]["year"], 2015);
+    ASSERT_TRUE(last.next.empty());
+
+    SelectPage back = query().before(last.previous).executePage();
+    ASSERT_EQ(back.documents, second.documents);
+
+    back = query().before(back.previous).executePage();
+    ASSERT_EQ(back.documents, first.documents);
+    ASSERT_TRUE(back.previous.empty());
+}
+
+TYPED_TEST(QueryPageTests, ShouldSelectPagesWithTiesAndMissingValues) {
+    Collection feed = this->q.collection("feed");
+
+    json posts = json::array();
+    for (int score : {3, 1, -1, 1, 2, -1, 1}) {
+        posts.push_back(score < 0 ? json {{"title", "untitled"}}
+                                  : json {{"score", score}});
+    }
+    this->q.from("feed").insert(posts);
+
+    auto query = [&]() {
+        return std::move(
+            this->q.from("feed")
+                .select(feed[common::internal_id_string], feed["score"])
+                .sortBy(feed["score"].desc())
+                .limit(2));
+    };
+
+    std::vector<json> pages;
+    std::set<std::string> ids;
+
+    SelectPage page = query().executePage();
+    while (true) {
+        pages.push_back(page.documents);
+        for (auto& post : page.documents) {
+            ids.insert(post[common::internal_id_string].get<std::string>());
+        }
+
+        if (page.next.empty()) break;
+        page = query().after(page.next).executePage();
+    }
+
+    ASSERT_EQ(pages.size(), 4);
+    ASSERT_EQ(ids.size(), posts.size());
+
+    // the missing scores go last when sorting descending
+    ASSERT_EQ(pages[0][0]["score"], 3);
+    ASSERT_FALSE(pages[3][0].contains("score"));
+
+    // and back to the first page
+    for (int i = (int)pages.size() - 2; i >= 0; i--) {
+        page = query().before(page.previous).executePage();
+        ASSERT_EQ(page.documents, pages[i]);
+    }
+
+    ASSERT_TRUE(page.previous.empty());
+}
+
+TYPED_TEST(QueryPageTests, ShouldSelectAfterADocument) {
+    Collection cars = this->q.collection("cars");
+
+    json car =
+        this->q.from("cars").select().where(cars["year"] == 2011).execute();
+    ASSERT_EQ(car.size(), 1);
+
+    json result = this->q.from("cars")
+                      .select(cars["year"])
+                      .sortBy(cars["year"].asc())
+                      .after(2011, car[0][common::internal_id_string])
+                      .execute();
+
+    ASSERT_EQ(result, json::array({{{"year", 2015}}}));
+
+    ASSERT_THROW(this->q.from("cars").select().after("[oops").execute(),
+                 std::runtime_error);
+
+    // same as getting a document by a bad id
+    ASSERT_THROW(this->q.from("cars").select().after(2011, "not an id"),
+                 std::runtime_error);
+}
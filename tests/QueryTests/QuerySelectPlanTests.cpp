@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include "QueryBaseCars.hpp"
+#include "nldb/Collection.hpp"
+#include "nldb/backends/sqlite3/Query/SelectPlan.hpp"
+
+using namespace nldb;
+
+template <typename T>
+class QuerySelectPlanTestsCars : public QueryCarsTest<T> {
+   public:
+    size_t cachedPlans() {
+        return this->q.getRepositories()->selectPlans->plans.size();
+    }
+};
+TYPED_TEST_SUITE(QuerySelectPlanTestsCars, TestDBTypes);
+
+TYPED_TEST(QuerySelectPlanTestsCars, ShouldReuseThePlanWithOtherValues) {
+    Collection cars = this->q.collection("cars");
+
+    auto byYear = [&](int year) {
+        return this->q.from("cars")
+            .select(cars["model"])
+            .where(cars["year"] == year)
+            .execute();
+    };
+
+    json focus = byYear(2011);
+    const size_t plans = this->cachedPlans();
+    ASSERT_GT(plans, 0);
+
+    json impreza = byYear(2003);
+    json none = byYear(1990);
+
+    ASSERT_EQ(this->cachedPlans(), plans);
+
+    ASSERT_EQ(focus.size(), 1);
+    ASSERT_EQ(focus[0]["model"], "focus");
+    ASSERT_EQ(impreza.size(), 1);
+    ASSERT_EQ(impreza[0]["model"], "impreza");
+    ASSERT_EQ(none.size(), 0);
+
+    // the pagination is bound too
+    auto page = [&](int number) {
+        return this->q.from("cars")
+            .select(cars["year"])
+            .sortBy(cars["year"].asc())
+            .page(number)
+            .limit(2)
+            .execute();
+    };
+
+    ASSERT_EQ(page(1), json({{{"year", 2003}}, {{"year", 2011}}}));
+    ASSERT_EQ(page(2), json({{{"year", 2015}}}));
+}
+
+TYPED_TEST(QuerySelectPlanTestsCars,
+           ShouldNotReuseThePlanAfterAddingProperties) {
+    json before = this->q.from("cars").select().execute();
+    ASSERT_EQ(before.size(), 3);
+
+    this->q.from("cars").insert({{"maker", "kia"}, {"color", "red"}});
+
+    Collection cars = this->q.collection("cars");
+    json after = this->q.from("cars")
+                     .select()
+                     .where(cars["maker"] == "kia")
+                     .execute();
+
+    json all = this->q.from("cars").select().execute();
+
+    ASSERT_EQ(after.size(), 1);
+    ASSERT_EQ(after[0]["color"], "red");
+    ASSERT_EQ(all.size(), 4);
+}
+
+TYPED_TEST(QuerySelectPlanTestsCars,
+           ShouldBindTheValuesLeftAfterMissingProperties) {
+    Collection cars = this->q.collection("cars");
+
+    // without a color the first condition is left out
+    auto redOr2003 = [&]() {
+        return this->q.from("cars")
+            .select(cars["model"])
+            .where(cars["color"] == "red" || cars["year"] == 2003)
+            .execute();
+    };
+
+    for (int i = 0; i < 2; i++) {
+        json found = redOr2003();
+        ASSERT_EQ(found.size(), 1);
+        ASSERT_EQ(found[0]["model"], "impreza");
+    }
+
+    this->q.from("cars").insert({{"model", "rio"}, {"color", "red"}});
+
+    json found = redOr2003();
+    ASSERT_EQ(found.size(), 2);
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+
+#include "QueryBaseCars.hpp"
+#include "nldb/Collection.hpp"
+
+template <typename T>
+class QueryStreamTests : public QueryCarsTest<T> {};
+
+TYPED_TEST_SUITE(QueryStreamTests, TestDBTypes);
+
+TYPED_TEST(QueryStreamTests, ShouldStreamTheSameDocumentsAsExecute) {
+    Collection cars = this->q.collection("cars");
+
+    json expected =
+        this->q.from("cars").select().sortBy(cars["year"].asc()).execute();
+
+    json streamed = json::array();
+    const long long read = this->q.from("cars")
+                               .select()
+                               .sortBy(cars["year"].asc())
+                               .stream([&streamed](json& car) {
+                                   streamed.push_back(std::move(car));
+                                   return true;
+                               });
+
+    ASSERT_EQ(read, this->data_cars.size());
+    ASSERT_EQ(streamed, expected);
+}
+
+TYPED_TEST(QueryStreamTests, ShouldStopStreaming) {
+    Collection cars = this->q.collection("cars");
+
+    std::vector<int> years;
+    const long long read =
+        this->q.from("cars")
+            .select(cars["year"])
+            .sortBy(cars["year"].desc())
+            .stream([&years](json& car) {
+                years.push_back(car["year"]);
+                return years.size() < 2;
+            });
+
+    ASSERT_EQ(read, 2);
+    ASSERT_EQ(years, std::vector<int>({2015, 2011}));
+
+    // the lock and the statement were released, the lock is recursive so
+    // only another thread can tell
+    auto inserted = std::async(std::launch::async, [this]() {
+        this->q.from("cars").insert({{"year", 2020}});
+    });
+
+    ASSERT_EQ(inserted.wait_for(std::chrono::seconds(5)),
+              std::future_status::ready);
+    inserted.get();
+
+    ASSERT_EQ(this->q.from("cars").select().execute().size(),
+              this->data_cars.size() + 1);
+}
+
+TYPED_TEST(QueryStreamTests, ShouldStreamNothingFromMissingCollections) {
+    const long long read =
+        this->q.from("boats").select().stream([](json&) { return true; });
+
+    ASSERT_EQ(read, 0);
+}
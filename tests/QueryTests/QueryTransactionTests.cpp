@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include "QueryBase.hpp"
+#include "nldb/Collection.hpp"
+#include "nldb/Common.hpp"
+
+using namespace nldb;
+
+template <typename T>
+class QueryTransactionTests : public QueryBaseTest<T> {
+   public:
+    int countDocuments(const char* collection) {
+        return this->q.from(collection).select().execute().size();
+    }
+
+    bool hasCollection(const std::string& name) {
+        for (auto& coll : this->q.getCollections()) {
+            if (coll.getName() == name) return true;
+        }
+
+        return false;
+    }
+};
+
+TYPED_TEST_SUITE(QueryTransactionTests, TestDBTypes);
+
+TYPED_TEST(QueryTransactionTests, ShouldCommitAllTheOperations) {
+    auto id = common::internal_id_string;
+    auto ids = this->q.from("test").insert({{"name", "a"}, {"n", 1}});
+
+    this->q.transaction([this, &ids](Transaction&) {
+        for (int i = 0; i < 100; i++) {
+            this->q.from("test").insert({{"name", "b"}, {"n", i}});
+        }
+
+        this->q.from("test").update(ids[0], {{"n", 1000}});
+    });
+
+    ASSERT_FALSE(this->db.isInTransaction());
+    ASSERT_EQ(this->countDocuments("test"), 101);
+
+    Collection test = this->q.collection("test");
+    json updated =
+        this->q.from("test").select().where(test[id] == ids[0]).execute();
+
+    ASSERT_EQ(updated.size(), 1);
+    ASSERT_EQ(updated[0]["n"], 1000);
+}
+
+TYPED_TEST(QueryTransactionTests, ShouldRollbackIfItThrows) {
+    this->q.from("test").insert({{"name", "a"}});
+
+    EXPECT_THROW(this->q.transaction([this](Transaction&) {
+        this->q.from("test").insert({{"name", "b"}, {"inner", {{"x", 1}}}});
+        this->q.from("other").insert({{"name", "c"}});
+
+        throw std::runtime_error("abort");
+    }),
+                 std::runtime_error);
+
+    ASSERT_FALSE(this->db.isInTransaction());
+    ASSERT_EQ(this->countDocuments("test"), 1);
+    ASSERT_FALSE(this->hasCollection("other"));
+
+    // the collections and properties it added are not cached
+    this->q.from("other").insert({{"name", "c"}, {"inner", {{"x", 1}}}});
+    ASSERT_EQ(this->countDocuments("other"), 1);
+    ASSERT_EQ(this->q.from("other").select().execute()[0]["inner"]["x"], 1);
+}
+
+TYPED_TEST(QueryTransactionTests, ShouldRollbackExplicitly) {
+    {
+        Transaction tx = this->q.transaction();
+        this->q.from("test").insert({{"name", "a"}});
+
+        ASSERT_TRUE(tx.isActive());
+        tx.rollback();
+        ASSERT_FALSE(tx.isActive());
+    }
+
+    {
+        // rolled back when it goes out of scope
+        Transaction tx = this->q.transaction();
+        this->q.from("test").insert({{"name", "b"}});
+    }
+
+    ASSERT_FALSE(this->db.isInTransaction());
+    ASSERT_FALSE(this->hasCollection("test"));
+
+    Transaction tx = this->q.transaction();
+    this->q.from("test").insert({{"name", "c"}});
+    tx.commit();
+
+    ASSERT_EQ(this->countDocuments("test"), 1);
+    ASSERT_THROW(tx.commit(), std::runtime_error);
+}
+
+TYPED_TEST(QueryTransactionTests, ShouldKeepWhatWasBufferedBefore) {
+    this->q.from("test").insert({{"name", "a"}});
+
+    {
+        Transaction tx = this->q.transaction();
+        this->q.from("test").insert({{"name", "b"}});
+        tx.rollback();
+    }
+
+    json result = this->q.from("test").select().execute();
+    ASSERT_EQ(result.size(), 1);
+    ASSERT_EQ(result[0]["name"], "a");
+}
+
+TYPED_TEST(QueryTransactionTests, ShouldMakeOtherThreadsWait) {
+    std::atomic<bool> inserted {false};
+    std::thread other;
+
+    {
+        Transaction tx = this->q.transaction();
+        this->q.from("test").insert({{"name", "a"}});
+
+        other = std::thread([this, &inserted]() {
+            this->q.from("test").insert({{"name", "b"}});
+            inserted = true;
+        });
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        EXPECT_FALSE(inserted);
+
+        tx.rollback();
+    }
+
+    other.join();
+
+    json result = this->q.from("test").select().execute();
+    ASSERT_EQ(result.size(), 1);
+    ASSERT_EQ(result[0]["name"], "b");
+}
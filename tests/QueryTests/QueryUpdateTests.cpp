@@ -1,9 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <cstdint>
+
 #include "QueryBase.hpp"
 #include "QueryBaseCars.hpp"
 #include "nldb/Collection.hpp"
 #include "nldb/Common.hpp"
+#include "nldb/Exceptions.hpp"
 #include "nldb/typedef.hpp"
 
 using namespace nldb;
@@ -209,4 +212,313 @@ TYPED_TEST(QueryUpdateTestsCars, ShouldMaybeNotThrowOnIntegerIntoDouble) {
         ADD_FAILURE() << "Unexpected exception thrown";
     }
 #endif
-}
\ No newline at end of file
+}
+
+TYPED_TEST(QueryUpdateTestsCars, ShouldUpdateTheSameDocumentManyTimes) {
+    Collection cars = this->q.collection("cars");
+    json car =
+        this->q.from("cars").select().where(cars["year"] == 2003).execute();
+
+    ASSERT_EQ(car.size(), 1);
+
+    const std::string id = car[0][common::internal_id_string];
+
+    // the updates are buffered, each one has to see the previous ones
+    this->q.from("cars").update(id, {{"year", 1}});
+    this->q.from("cars").update(id, {{"year", 2}, {"engine", {{"hp", 1}}}});
+    this->q.from("cars").update(id, {{"engine", {{"hp", 2}}}});
+    this->q.from("cars").update(id, {{"year", 3}, {"model", "wrx"}});
+
+    json updated = this->q.from("cars")
+                       .select()
+                       .where(cars[common::internal_id_string] == id)
+                       .execute();
+
+    ASSERT_EQ(updated.size(), 1);
+    ASSERT_EQ(updated[0]["year"], 3);
+    ASSERT_EQ(updated[0]["model"], "wrx");
+    ASSERT_EQ(updated[0]["engine"]["hp"], 2);
+    ASSERT_NEAR(updated[0]["technical"]["0-60 mph"], 3.1, 1e-2);
+
+    // technical and a single engine
+    ASSERT_EQ(this->db.executeAndGetFirstInt(
+                  "select count(*) from object where obj_id = @id;",
+                  {{"@id", std::stoll(id)}}),
+              2);
+}
+
+TYPED_TEST(QueryUpdateTestsCars, ShouldApplyNumericOperators) {
+    Collection cars = this->q.collection("cars");
+    json car =
+        this->q.from("cars").select().where(cars["year"] == 2003).execute();
+
+    ASSERT_EQ(car.size(), 1);
+
+    const std::string id = car[0][common::internal_id_string];
+
+    auto find = [&]() {
+        return this->q.from("cars")
+            .select()
+            .where(cars[common::internal_id_string] == id)
+            .execute()[0];
+    };
+
+    // a buffered value is combined too
+    this->q.from("cars").update(id, {{"year", 2000}});
+    this->q.from("cars").update(id, {{"year", {{"$inc", 5}}}});
+    ASSERT_EQ(find()["year"], 2005);
+
+    // missing properties are set to the operand
+    this->q.from("cars").update(id, {{"views", {{"$inc", 1}}}});
+    this->q.from("cars").update(id, {{"views", {{"$inc", 1}}}});
+    ASSERT_EQ(find()["views"], 2);
+
+    this->q.from("cars").update(id, {{"year", {{"$min", 2010}}}});
+    ASSERT_EQ(find()["year"], 2005);
+
+    this->q.from("cars").update(id, {{"year", {{"$max", 2010}}}});
+    ASSERT_EQ(find()["year"], 2010);
+
+    // integers into doubles, in sub-documents, applied by name
+    this->q.from("cars").update(
+        id, {{"technical", {{"0-60 mph", {{"$min", 3}, {"$inc", 0.5}}}}}});
+    ASSERT_NEAR(find()["technical"]["0-60 mph"], 3, 1e-2);
+}
+
+TYPED_TEST(QueryUpdateTestsCars, ShouldApplyNumericOperatorsByWhere) {
+    Collection cars = this->q.collection("cars");
+
+    const int updated =
+        this->q.from("cars")
+            .where(cars["maker"] == "ford")
+            .update({{"year", {{"$inc", 1}}}, {"views", {{"$max", 5}}}});
+
+    ASSERT_EQ(updated, 2);
+
+    json result =
+        this->q.from("cars").select().sortBy(cars["year"].asc()).execute();
+
+    ASSERT_EQ(result.size(), 3);
+    ASSERT_EQ(result[0]["year"], 2003);
+    ASSERT_FALSE(result[0].contains("views"));
+    ASSERT_EQ(result[1]["year"], 2012);
+    ASSERT_EQ(result[1]["views"], 5);
+    ASSERT_EQ(result[2]["year"], 2016);
+    ASSERT_EQ(result[2]["views"], 5);
+}
+
+TYPED_TEST(QueryUpdateTestsCars, ShouldCheckNumericOperatorTypes) {
+    Collection cars = this->q.collection("cars");
+    json car =
+        this->q.from("cars").select().where(cars["year"] == 2003).execute();
+
+    ASSERT_EQ(car.size(), 1);
+
+    const std::string id = car[0][common::internal_id_string];
+
+    ASSERT_THROW(
+        this->q.from("cars").update(id, {{"maker", {{"$inc", 1}}}}),
+        WrongPropertyType);
+
+    ASSERT_THROW(
+        this->q.from("cars").update(id, {{"views", {{"$inc", "one"}}}}),
+        WrongPropertyType);
+
+    ASSERT_THROW(this->q.from("cars").update(
+                     id, {{"technical", {{"$inc", 1}, {"length", 2}}}}),
+                 InvalidUpdate);
+}
+
+TYPED_TEST(QueryUpdateTestsCars, ShouldRejectOverflowingIncrements) {
+    Collection cars = this->q.collection("cars");
+    json car =
+        this->q.from("cars").select().where(cars["year"] == 2003).execute();
+
+    const std::string id = car[0][common::internal_id_string];
+
+    this->q.from("cars").update(id, {{"views", INT64_MAX}});
+    ASSERT_THROW(this->q.from("cars").update(id, {{"views", {{"$inc", 1}}}}),
+                 InvalidUpdate);
+
+    this->q.from("cars").update(id, {{"views", INT64_MIN}});
+    ASSERT_THROW(this->q.from("cars").update(id, {{"views", {{"$inc", -1}}}}),
+                 InvalidUpdate);
+
+    ASSERT_THROW(this->q.from("cars")
+                     .where(cars["year"] == 2003)
+                     .update({{"views", {{"$inc", -1}}}}),
+                 InvalidUpdate);
+
+    json result =
+        this->q.from("cars").select().where(cars["year"] == 2003).execute();
+
+    ASSERT_EQ(result[0]["views"], INT64_MIN);
+}
+
+TYPED_TEST(QueryUpdateTestsCars, ShouldUpdateByWhere) {
+    Collection cars = this->q.collection("cars");
+
+    const int updated = this->q.from("cars")
+                            .where(cars["maker"] == "ford")
+                            .update({{"legacy", true}, {"year", 2000}});
+
+    ASSERT_EQ(updated, 2);
+
+    json result =
+        this->q.from("cars").select().sortBy(cars["year"].asc()).execute();
+
+    ASSERT_EQ(result.size(), 3);
+
+    for (int i = 0; i < 2; i++) {
+        ASSERT_EQ(result[i]["maker"], "ford");
+        ASSERT_EQ(result[i]["year"], 2000);
+        ASSERT_EQ(result[i]["legacy"], true);
+    }
+
+    ASSERT_EQ(result[2]["maker"], "subaru");
+    ASSERT_EQ(result[2]["year"], 2003);
+    ASSERT_FALSE(result[2].contains("legacy"));
+}
+
+TYPED_TEST(QueryUpdateTestsCars, ShouldMatchBeforeUpdatingByWhere) {
+    Collection cars = this->q.collection("cars");
+
+    // year is updated before legacy is set, it still needs to be set
+    const int updated = this->q.from("cars")
+                            .where(cars["year"] == 2003)
+                            .update({{"year", 2004}, {"legacy", true}});
+
+    ASSERT_EQ(updated, 1);
+
+    json result =
+        this->q.from("cars").select().where(cars["legacy"] == true).execute();
+
+    ASSERT_EQ(result.size(), 1);
+    ASSERT_EQ(result[0]["model"], "impreza");
+    ASSERT_EQ(result[0]["year"], 2004);
+}
+
+TYPED_TEST(QueryUpdateTestsCars, ShouldUpdateInnerFieldsByWhere) {
+    Collection cars = this->q.collection("cars");
+
+    const int updated =
+        this->q.from("cars")
+            .where(cars["technical"]["0-60 mph"] > 4)
+            .where(cars["model"] == "focus")
+            .update({{"technical", {{"weight", "1 kg"}, {"0-60 mph", 1.5}}},
+                     {"engine", {{"hp", 100}}}});
+
+    ASSERT_EQ(updated, 2);
+
+    json result =
+        this->q.from("cars").select().sortBy(cars["year"].asc()).execute();
+
+    ASSERT_EQ(result.size(), 3);
+
+    // subaru
+    ASSERT_NEAR(result[0]["technical"]["0-60 mph"], 3.1, 1e-2);
+    ASSERT_FALSE(result[0]["technical"].contains("weight"));
+    ASSERT_FALSE(result[0].contains("engine"));
+
+    for (int i = 1; i < 3; i++) {
+        ASSERT_EQ(result[i]["technical"]["weight"], "1 kg");
+        ASSERT_NEAR(result[i]["technical"]["0-60 mph"], 1.5, 1e-2);
+        ASSERT_EQ(result[i]["engine"]["hp"], 100);
+    }
+
+    // the rest of the inner fields are kept
+    ASSERT_EQ(result[1]["technical"]["length"], 4);
+    ASSERT_NEAR(result[2]["technical"]["width"], 2.1, 1e-2);
+}
+
+TYPED_TEST(QueryUpdateTestsCars, ShouldNotUpdateByWhereWithMissingProperty) {
+    Collection cars = this->q.collection("cars");
+
+    ASSERT_THROW(this->q.from("cars")
+                     .where(cars["color"] == "red")
+                     .update({{"legacy", true}}),
+                 PropertyNotFound);
+
+    ASSERT_EQ(this->q.from("boats")
+                  .where(cars["year"] == 2003)
+                  .update({{"legacy", true}}),
+              0);
+}
+
+TYPED_TEST(QueryUpdateTestsCars, ShouldCheckTypesOnUpdateByWhere) {
+    Collection cars = this->q.collection("cars");
+
+    ASSERT_THROW(this->q.from("cars")
+                     .where(cars["year"] == 2003)
+                     .update({{"year", "two thousand"}}),
+                 WrongPropertyType);
+}
+
+TYPED_TEST(QueryUpdateTestsCars, ShouldUpdateAllOrNothingByWhere) {
+    Collection cars = this->q.collection("cars");
+
+    // legacy is set before the year fails
+    ASSERT_THROW(this->q.from("cars")
+                     .where(cars["maker"] == "ford")
+                     .update({{"legacy", true}, {"year", "two thousand"}}),
+                 WrongPropertyType);
+
+    ASSERT_FALSE(this->db.isInTransaction());
+
+    json result = this->q.from("cars").select().execute();
+    ASSERT_EQ(result.size(), 3);
+
+    for (auto& car : result) ASSERT_FALSE(car.contains("legacy"));
+}
+
+TYPED_TEST(QueryUpdateTestsCars, ShouldCommitThePropertiesAddedByWhere) {
+    auto id = common::internal_id_string;
+
+    QueryConfiguration cfg;
+    cfg.FlushesPerCommit = 3;
+
+    Query<TypeParam> query(&this->db, cfg);
+    Collection cars = query.collection("cars");
+
+    query.from("cars")
+        .where(cars["maker"] == "ford")
+        .update({{"legacy", true}, {"views", {{"$inc", 1}}}});
+
+    ASSERT_FALSE(this->db.isInTransaction());
+
+    // a failed flush doesn't roll back the new properties
+    query.from("cars").insert({{id, 50}, {"maker", "kia"}});
+    ASSERT_ANY_THROW(query.from("cars").insert({{id, 50}, {"maker", "kia"}}));
+
+    json result = query.from("cars")
+                      .select()
+                      .where(cars["legacy"] == true && cars["views"] == 1)
+                      .execute();
+    ASSERT_EQ(result.size(), 2);
+}
+
+TYPED_TEST(QueryUpdateTestsCars, ShouldCommitThePropertiesAddedByOperators) {
+    auto id = common::internal_id_string;
+
+    QueryConfiguration cfg;
+    cfg.FlushesPerCommit = 3;
+
+    Query<TypeParam> query(&this->db, cfg);
+    Collection cars = query.collection("cars");
+
+    json car =
+        query.from("cars").select().where(cars["year"] == 2003).execute();
+    const std::string carID = car[0][id];
+
+    query.from("cars").update(carID, {{"views", {{"$inc", 1}}}});
+    ASSERT_FALSE(this->db.isInTransaction());
+
+    // a failed flush doesn't roll back the new property
+    query.from("cars").insert({{id, 50}, {"maker", "kia"}});
+    ASSERT_ANY_THROW(query.from("cars").insert({{id, 50}, {"maker", "kia"}}));
+
+    json result =
+        query.from("cars").select().where(cars["views"] == 1).execute();
+    ASSERT_EQ(result.size(), 1);
+    ASSERT_EQ(result[0]["year"], 2003);
+}
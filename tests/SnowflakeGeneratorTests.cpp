@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "nldb/SnowflakeGenerator.hpp"
+
+using namespace nldb;
+
+TEST(SnowflakeGeneratorTest, IncreasesWithinAThread) {
+    snowflake last = SnowflakeGenerator::generate();
+
+    for (int i = 0; i < 3 * SnowflakeGenerator::blockSize; i++) {
+        const snowflake id = SnowflakeGenerator::generate();
+        ASSERT_GT(id, last);
+        last = id;
+    }
+}
+
+TEST(SnowflakeGeneratorTest, StartsAtTheCurrentTime) {
+    const snowflake now =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count();
+
+    // a new thread reserves a new block
+    snowflake id;
+    std::thread([&id]() { id = SnowflakeGenerator::generate(); }).join();
+
+    EXPECT_GE(id >> SnowflakeGenerator::sequenceBits, now);
+}
+
+TEST(SnowflakeGeneratorTest, ShouldNotCollideBetweenThreads) {
+    // more threads than the previous generator could tell apart
+    const int threadsCount = 200;
+    const int idsPerThread = 10000;
+
+    std::vector<std::vector<snowflake>> generated(threadsCount);
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < threadsCount; i++) {
+        threads.emplace_back([&ids = generated[i]]() {
+            ids.reserve(idsPerThread);
+            for (int j = 0; j < idsPerThread; j++) {
+                ids.push_back(SnowflakeGenerator::generate());
+            }
+        });
+    }
+
+    for (auto& thread : threads) thread.join();
+
+    std::vector<snowflake> all;
+    all.reserve(threadsCount * idsPerThread);
+    for (auto& ids : generated) all.insert(all.end(), ids.begin(), ids.end());
+
+    std::sort(all.begin(), all.end());
+
+    EXPECT_EQ(std::adjacent_find(all.begin(), all.end()), all.end());
+}
+
+TEST(SnowflakeGeneratorTest, ShouldGenerateMillionsPerSecondAcrossCores) {
+    const int threadsCount =
+        std::max(2u, std::thread::hardware_concurrency());
+    const int idsPerThread = 1000000;
+
+    std::vector<snowflake> last(threadsCount);
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < threadsCount; i++) {
+        threads.emplace_back([&id = last[i]]() {
+            for (int j = 0; j < idsPerThread; j++) {
+                id = SnowflakeGenerator::generate();
+            }
+        });
+    }
+
+    for (auto& thread : threads) thread.join();
+
+    const double seconds = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+    const double idsPerSecond = threadsCount * idsPerThread / seconds;
+
+    RecordProperty("ids_per_second", std::to_string(idsPerSecond));
+
+    // far below what it does, so a busy machine doesn't fail it
+    EXPECT_GT(idsPerSecond, 1000000);
+}
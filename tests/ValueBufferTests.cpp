@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <string>
+#include <vector>
+
 #include "nldb/Utils/ValueBuffer.hpp"
 
 using namespace nldb;
@@ -39,4 +42,95 @@ TEST_F(ValueBufferTest, SimpleAdd) {
         EXPECT_TRUE(isLast);
         EXPECT_EQ(el, 42);
     });
-}
\ No newline at end of file
+}
+
+TEST(DoubleBufferTest, ShouldKeepAddingWhileFrozen) {
+    DoubleBuffer<int> buffer(2);
+
+    EXPECT_TRUE(buffer.Add(1));
+    EXPECT_TRUE(buffer.Add(2));
+    EXPECT_FALSE(buffer.Add(3));
+
+    EXPECT_EQ(buffer.Freeze(), 2);
+    EXPECT_EQ(buffer.Size(), 0);
+
+    // the active half is empty while the frozen one is consumed
+    EXPECT_TRUE(buffer.Add(3));
+
+    std::vector<int> frozen;
+    buffer.ForEachFrozen([&frozen](int el, bool isLast) {
+        frozen.push_back(el);
+        EXPECT_EQ(isLast, el == 2);
+    });
+
+    EXPECT_EQ(frozen, std::vector<int>({1, 2}));
+
+    buffer.ReleaseFrozen();
+    EXPECT_EQ(buffer.FrozenSize(), 0);
+
+    EXPECT_EQ(buffer.Freeze(), 1);
+    buffer.ForEachFrozen([](int el, bool isLast) {
+        EXPECT_EQ(el, 3);
+        EXPECT_TRUE(isLast);
+    });
+
+    buffer.Reset();
+    EXPECT_EQ(buffer.FrozenSize(), 0);
+    EXPECT_EQ(buffer.Size(), 0);
+}
+
+TEST(DoubleBufferTest, ShouldAddManyUpToTheCapacity) {
+    DoubleBuffer<int> buffer(3);
+    std::vector<int> values = {1, 2, 3, 4, 5};
+
+    auto next = buffer.AddMany(values.begin(), values.end());
+    EXPECT_EQ(next, values.begin() + 3);
+    EXPECT_EQ(buffer.Size(), 3);
+
+    EXPECT_EQ(buffer.Freeze(), 3);
+    EXPECT_EQ(buffer.AddMany(next, values.end()), values.end());
+    EXPECT_EQ(buffer.Size(), 2);
+}
+
+TEST(StringArenaTest, ShouldKeepTheStringsUntilReset) {
+    StringArena arena(8);
+
+    std::string_view a = arena.Store("abc");
+    std::string_view b = arena.Store("defgh");
+
+    // doesn't fit in the first chunk
+    std::string_view c = arena.Store("a longer string");
+
+    EXPECT_EQ(a, "abc");
+    EXPECT_EQ(b, "defgh");
+    EXPECT_EQ(c, "a longer string");
+    EXPECT_EQ(arena.Store(""), "");
+
+    // both chunks are merged, the next cycle fits in one
+    arena.Reset();
+    EXPECT_EQ(arena.Capacity(), 8 + 15);
+
+    EXPECT_EQ(arena.Store("xyz"), "xyz");
+    EXPECT_EQ(arena.Capacity(), 8 + 15);
+}
+
+TEST(DoubleBufferTest, ShouldCopyThePayloadIntoTheArena) {
+    struct Named {
+        int id;
+        std::string_view name;
+    };
+
+    DoubleBuffer<Named, std::mutex> buffer(10, 64);
+
+    {
+        std::string name = "temporary name";
+        EXPECT_TRUE(buffer.Add(Named {1, name}, &Named::name));
+    }
+
+    EXPECT_EQ(buffer.Freeze(), 1);
+    buffer.ForEachFrozen([](Named& el, bool) {
+        EXPECT_EQ(el.id, 1);
+        EXPECT_EQ(el.name, "temporary name");
+    });
+    buffer.ReleaseFrozen();
+}